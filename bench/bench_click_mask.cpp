@@ -0,0 +1,247 @@
+// 点击区域蒙版基准测试：4K蒙版 → 矩形列表
+// 构建：scons bench，运行：bin/bench_click_mask [iterations]
+
+#include "bench_common.h"
+#include "click_mask.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static const int32_t WIDTH = 3840;
+static const int32_t HEIGHT = 2160;
+
+// 生成测试蒙版，每像素bytes_per_pixel字节，透明度在最后一个字节
+static std::vector<uint8_t> make_mask(const char* kind, int32_t bytes_per_pixel) {
+    std::vector<uint8_t> pixels((size_t)WIDTH * HEIGHT * bytes_per_pixel, 0);
+    uint32_t seed = 12345;
+    for (int32_t y = 0; y < HEIGHT; y++) {
+        for (int32_t x = 0; x < WIDTH; x++) {
+            uint8_t alpha = 0;
+            if (strcmp(kind, "opaque") == 0) {
+                alpha = 255;
+            } else if (strcmp(kind, "disc") == 0) {
+                // 屏幕中央的大圆（桌宠/悬浮窗的典型形状）
+                float dx = x - WIDTH * 0.5f;
+                float dy = y - HEIGHT * 0.5f;
+                alpha = dx * dx + dy * dy < 900.0f * 900.0f ? 255 : 0;
+            } else if (strcmp(kind, "sprites") == 0) {
+                // 64x36个小圆，矩形数量较多
+                float dx = (x % 60) - 30.0f;
+                float dy = (y % 60) - 30.0f;
+                alpha = dx * dx + dy * dy < 24.0f * 24.0f ? 255 : 0;
+            } else if (strcmp(kind, "noise") == 0) {
+                // 随机噪声，最坏情况
+                seed = seed * 1103515245u + 12345u;
+                alpha = (uint8_t)(seed >> 24);
+            }
+            uint8_t* p = pixels.data() + ((size_t)y * WIDTH + x) * bytes_per_pixel;
+            memset(p, 128, bytes_per_pixel - 1);
+            p[bytes_per_pixel - 1] = alpha;
+        }
+    }
+    return pixels;
+}
+
+// 逐像素的参考实现，用于对比SIMD版本的结果与速度
+static void threshold_row_scalar(const uint8_t* row, int32_t width, int32_t bytes_per_pixel,
+                                 uint8_t threshold, uint64_t* r_bits) {
+    const uint8_t* p = row + bytes_per_pixel - 1;
+    for (int32_t x = 0; x < width; x += 64) {
+        uint64_t word = 0;
+        int32_t count = std::min(64, width - x);
+        for (int32_t i = 0; i < count; i++) {
+            word |= (uint64_t)(p[(size_t)(x + i) * bytes_per_pixel] >= threshold) << i;
+        }
+        r_bits[x >> 6] = word;
+    }
+}
+
+// 在蒙版上画/擦一个实心圆（动画精灵），返回包围盒
+static MaskRect draw_disc(std::vector<uint8_t>& pixels, int32_t bytes_per_pixel, int32_t cx, int32_t cy, int32_t radius, uint8_t alpha) {
+    MaskRect bounds;
+    bounds.x = std::max(0, cx - radius);
+    bounds.y = std::max(0, cy - radius);
+    bounds.width = std::min(WIDTH, cx + radius) - bounds.x;
+    bounds.height = std::min(HEIGHT, cy + radius) - bounds.y;
+    for (int32_t y = bounds.y; y < bounds.y + bounds.height; y++) {
+        for (int32_t x = bounds.x; x < bounds.x + bounds.width; x++) {
+            int32_t dx = x - cx;
+            int32_t dy = y - cy;
+            if (dx * dx + dy * dy < radius * radius) {
+                pixels[((size_t)y * WIDTH + x) * bytes_per_pixel + bytes_per_pixel - 1] = alpha;
+            }
+        }
+    }
+    return bounds;
+}
+
+static MaskRect union_rect(const MaskRect& a, const MaskRect& b) {
+    MaskRect r;
+    r.x = std::min(a.x, b.x);
+    r.y = std::min(a.y, b.y);
+    r.width = std::max(a.x + a.width, b.x + b.width) - r.x;
+    r.height = std::max(a.y + a.height, b.y + b.height) - r.y;
+    return r;
+}
+
+// 逐帧增量更新：静止、缓慢移动（有/无脏区域提示）、整帧变化
+static void bench_updates(const char* format_name, ClickMaskFormat format, int32_t bytes_per_pixel,
+                          uint64_t iterations, std::vector<BenchResult>& results) {
+    const size_t stride = (size_t)WIDTH * bytes_per_pixel;
+    const std::string prefix = std::string("4k_") + format_name + "_update_";
+    std::vector<uint8_t> pixels((size_t)WIDTH * HEIGHT * bytes_per_pixel, 0);
+    ClickMask mask;
+    uint64_t region_calls = 0;
+    uint64_t changed_rows = 0;
+
+    auto finish = [&](BenchResult result, uint64_t frames) {
+        // 预热帧也计入，按总帧数折算
+        result.extra.push_back(std::make_pair("region_calls_per_frame", (double)region_calls / frames));
+        result.extra.push_back(std::make_pair("changed_rows_per_frame", (double)changed_rows / frames));
+        result.extra.push_back(std::make_pair("rects", (double)mask.get_rects().size()));
+        results.push_back(result);
+    };
+    const uint64_t frames = iterations + std::min<uint64_t>(iterations / 10 + 1, 100);
+
+    // 静止：每帧提交同一张蒙版
+    draw_disc(pixels, bytes_per_pixel, WIDTH / 2, HEIGHT / 2, 600, 255);
+    mask.build(pixels.data(), WIDTH, HEIGHT, stride, format, 128);
+    region_calls = changed_rows = 0;
+    finish(bench_run(prefix + "static", iterations, 1, [&]() {
+        region_calls += mask.update(pixels.data(), WIDTH, HEIGHT, stride, format, 128);
+        changed_rows += mask.get_changed_rows();
+    }), frames);
+
+    // 缓慢变化：256像素的精灵每帧水平移动4像素
+    for (int pass = 0; pass < 2; pass++) {
+        bool hint = pass == 1;
+        std::fill(pixels.begin(), pixels.end(), 0);
+        int32_t x = 400;
+        MaskRect previous = draw_disc(pixels, bytes_per_pixel, x, HEIGHT / 2, 128, 255);
+        MaskRect dirty = previous;
+        mask.build(pixels.data(), WIDTH, HEIGHT, stride, format, 128);
+        region_calls = changed_rows = 0;
+        finish(bench_run_setup(prefix + (hint ? "slow_hint" : "slow"), iterations, 1, [&]() {
+            draw_disc(pixels, bytes_per_pixel, x, HEIGHT / 2, 128, 0);
+            x = x + 4 < WIDTH - 400 ? x + 4 : 400;
+            MaskRect current = draw_disc(pixels, bytes_per_pixel, x, HEIGHT / 2, 128, 255);
+            dirty = union_rect(previous, current);
+            previous = current;
+        }, [&]() {
+            region_calls += mask.update(pixels.data(), WIDTH, HEIGHT, stride, format, 128, hint ? &dirty : nullptr);
+            changed_rows += mask.get_changed_rows();
+        }), frames);
+    }
+
+    // 整帧变化：两张完全不同的蒙版交替
+    std::vector<uint8_t> frame_a = make_mask("disc", bytes_per_pixel);
+    std::vector<uint8_t> frame_b = make_mask("sprites", bytes_per_pixel);
+    uint64_t frame = 0;
+    mask.build(frame_a.data(), WIDTH, HEIGHT, stride, format, 128);
+    region_calls = changed_rows = 0;
+    finish(bench_run(prefix + "full", iterations, 1, [&]() {
+        const std::vector<uint8_t>& current = (++frame & 1) ? frame_b : frame_a;
+        region_calls += mask.update(current.data(), WIDTH, HEIGHT, stride, format, 128);
+        changed_rows += mask.get_changed_rows();
+    }), frames);
+}
+
+int main(int argc, char** argv) {
+    uint64_t iterations = argc > 1 ? strtoull(argv[1], nullptr, 10) : 50;
+    const char* kinds[] = { "opaque", "transparent", "disc", "sprites", "noise" };
+    const uint8_t threshold = 128;
+    const size_t words_per_row = (WIDTH + 63) / 64;
+    std::vector<BenchResult> results;
+
+    struct FormatCase {
+        const char* name;
+        ClickMaskFormat format;
+        int32_t bytes_per_pixel;
+    };
+    const FormatCase formats[] = {
+        { "rgba8", CLICK_MASK_RGBA8, 4 },
+        { "alpha8", CLICK_MASK_ALPHA8, 1 },
+    };
+
+    ClickMask mask;
+    std::vector<uint64_t> simd_bits(words_per_row * HEIGHT);
+    std::vector<uint64_t> scalar_bits(words_per_row * HEIGHT);
+
+    for (const FormatCase& format : formats) {
+        for (const char* kind : kinds) {
+            std::vector<uint8_t> pixels = make_mask(kind, format.bytes_per_pixel);
+            size_t stride = (size_t)WIDTH * format.bytes_per_pixel;
+            std::string prefix = std::string("4k_") + format.name + "_" + kind;
+
+            // 完整转换：阈值化 + 提取区间 + 行合并
+            BenchResult build = bench_run(prefix + "_build", iterations, 1, [&]() {
+                mask.build(pixels.data(), WIDTH, HEIGHT, stride, format.format, threshold);
+                bench_do_not_optimize(mask.get_rects().size());
+            });
+            build.extra.push_back(std::make_pair("rects", (double)mask.get_rects().size()));
+            build.extra.push_back(std::make_pair("input_mb", (double)pixels.size() / (1024.0 * 1024.0)));
+            results.push_back(build);
+
+            // 只比较阈值化部分：SIMD与逐像素实现
+            BenchResult simd = bench_run(prefix + "_threshold_simd", iterations, 1, [&]() {
+                for (int32_t y = 0; y < HEIGHT; y++) {
+                    ClickMask::threshold_row(pixels.data() + stride * y, WIDTH, format.format, threshold,
+                                             simd_bits.data() + words_per_row * y);
+                }
+                bench_do_not_optimize(simd_bits[0]);
+            });
+            BenchResult scalar = bench_run(prefix + "_threshold_scalar", iterations, 1, [&]() {
+                for (int32_t y = 0; y < HEIGHT; y++) {
+                    threshold_row_scalar(pixels.data() + stride * y, WIDTH, format.bytes_per_pixel, threshold,
+                                         scalar_bits.data() + words_per_row * y);
+                }
+                bench_do_not_optimize(scalar_bits[0]);
+            });
+            if (simd_bits != scalar_bits) {
+                fprintf(stderr, "threshold mismatch: %s\n", prefix.c_str());
+                return 1;
+            }
+            results.push_back(simd);
+            results.push_back(scalar);
+
+            // 一次性转换为ALPHA8（convert_click_mask），之后按ALPHA8提交
+            if (format.format != CLICK_MASK_ALPHA8) {
+                std::vector<uint8_t> alpha((size_t)WIDTH * HEIGHT);
+                results.push_back(bench_run(prefix + "_extract_alpha", iterations, 1, [&]() {
+                    ClickMask::extract_alpha(pixels.data(), WIDTH, HEIGHT, stride, format.format, alpha.data());
+                    bench_do_not_optimize(alpha[0]);
+                }));
+                for (int32_t y = 0; y < HEIGHT; y++) {
+                    ClickMask::threshold_row(alpha.data() + (size_t)WIDTH * y, WIDTH, CLICK_MASK_ALPHA8, threshold,
+                                             simd_bits.data() + words_per_row * y);
+                }
+                if (simd_bits != scalar_bits) {
+                    fprintf(stderr, "extract_alpha mismatch: %s\n", prefix.c_str());
+                    return 1;
+                }
+            }
+        }
+    }
+
+    bench_updates("rgba8", CLICK_MASK_RGBA8, 4, iterations, results);
+    bench_updates("alpha8", CLICK_MASK_ALPHA8, 1, iterations, results);
+
+    // 多边形：五角星
+    std::vector<float> star;
+    for (int i = 0; i < 10; i++) {
+        float angle = (float)i * 3.14159265f / 5.0f;
+        float radius = (i % 2) ? 400.0f : 1000.0f;
+        star.push_back(WIDTH * 0.5f + radius * std::sin(angle));
+        star.push_back(HEIGHT * 0.5f - radius * std::cos(angle));
+    }
+    BenchResult polygon = bench_run("4k_polygon_star_build", iterations, 1, [&]() {
+        mask.build_polygon(star.data(), star.size() / 2, WIDTH, HEIGHT);
+        bench_do_not_optimize(mask.get_rects().size());
+    });
+    polygon.extra.push_back(std::make_pair("rects", (double)mask.get_rects().size()));
+    results.push_back(polygon);
+
+    bench_print_json("click_mask", results);
+    return 0;
+}
@@ -0,0 +1,96 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+// 基准测试公共部分：计时、统计与JSON输出（不依赖godot-cpp）
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 单项测试结果，extra为附加的数值字段（例如矩形数量）
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double p50_ns = 0.0;
+    double p99_ns = 0.0;
+    double mean_ns = 0.0;
+    double ops_per_sec = 0.0;
+    std::vector<std::pair<std::string, double>> extra;
+};
+
+inline uint64_t bench_now_ns() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 每次迭代单独计时，setup在计时之外执行（例如准备下一帧数据）；
+// ops_per_iteration为一次迭代包含的操作数（批量测试时大于1）
+template <typename S, typename F>
+BenchResult bench_run_setup(const std::string& name, uint64_t iterations, uint64_t ops_per_iteration, S&& setup, F&& body) {
+    // 预热，排除首次分配与缓存冷启动
+    for (uint64_t i = 0; i < std::min<uint64_t>(iterations / 10 + 1, 100); i++) {
+        setup();
+        body();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    double total = 0.0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        setup();
+        uint64_t start = bench_now_ns();
+        body();
+        double elapsed = (double)(bench_now_ns() - start);
+        samples.push_back(elapsed);
+        total += elapsed;
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    if (!samples.empty()) {
+        result.p50_ns = samples[samples.size() / 2];
+        result.p99_ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        result.mean_ns = total / samples.size();
+        result.ops_per_sec = total > 0.0 ? (double)(iterations * ops_per_iteration) * 1e9 / total : 0.0;
+    }
+    return result;
+}
+
+template <typename F>
+BenchResult bench_run(const std::string& name, uint64_t iterations, uint64_t ops_per_iteration, F&& body) {
+    return bench_run_setup(name, iterations, ops_per_iteration, []() {}, body);
+}
+
+// 输出为一个JSON文档：{"suite": ..., "results": [...]}
+inline void bench_print_json(const char* suite, const std::vector<BenchResult>& results) {
+    printf("{\n  \"suite\": \"%s\",\n  \"results\": [\n", suite);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        printf("    {\"name\": \"%s\", \"iterations\": %llu, \"p50_ns\": %.1f, \"p99_ns\": %.1f, \"mean_ns\": %.1f, \"ops_per_sec\": %.1f",
+               r.name.c_str(), (unsigned long long)r.iterations, r.p50_ns, r.p99_ns, r.mean_ns, r.ops_per_sec);
+        for (const auto& field : r.extra) {
+            printf(", \"%s\": %.6g", field.first.c_str(), field.second);
+        }
+        printf("}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+// 防止编译器优化掉基准测试中的计算结果
+template <typename T>
+inline void bench_do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+#endif // BENCH_COMMON_H
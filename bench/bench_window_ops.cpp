@@ -0,0 +1,242 @@
+// 窗口操作基准测试：句柄解析（包括按窗口ID）、hide/show/is_visible、set_clickable（伪后端，1/10/100个窗口）
+// 测的是扩展内部的逻辑（句柄缓存、影子状态、批处理、异步队列），不包含Godot绑定与系统调用。
+// 构建：scons bench，运行：bin/bench_window_ops [iterations]
+
+#include "bench_common.h"
+#include "window_backend_fake.h"
+#include "window_executor.h"
+#include "window_slot_table.h"
+#include "window_style_manager.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+// 每组测试使用新的管理器与伪后端，窗口ID为1..count
+struct BenchWindows {
+    WindowStyleManager manager;
+    FakeWindowBackend* backend = nullptr;
+    std::vector<uint32_t> window_ids;
+
+    explicit BenchWindows(size_t count) {
+        backend = new FakeWindowBackend();
+        manager.set_backend(std::unique_ptr<WindowBackend>(backend));
+        manager.set_handle_lookup(FakeWindowBackend::lookup_handle, backend);
+        for (size_t i = 0; i < count; i++) {
+            uint32_t window_id = (uint32_t)i + 1;
+            backend->create_window(window_id);
+            window_ids.push_back(window_id);
+        }
+    }
+
+    WindowRecord* resolve(uint32_t window_id) {
+        // 所属对象ID与窗口ID相同，模拟每个Window对象各自一个窗口
+        return manager.resolve(window_id, window_id);
+    }
+};
+
+static WindowStyleRequest taskbar_request(bool visible) {
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = visible;
+    return request;
+}
+
+static WindowStyleRequest clickable_request(bool clickable) {
+    WindowStyleRequest request;
+    request.set_clickable = true;
+    request.clickable = clickable;
+    return request;
+}
+
+// 按窗口ID查找：槽位表取出窗口ID后查找句柄缓存（与hide_id等方法的快速路径相同）
+static BenchResult bench_resolve_slot(const std::string& name, size_t count, uint64_t iterations) {
+    BenchWindows windows(count);
+    WindowSlotTable slots;
+    std::vector<int64_t> ids;
+    for (uint32_t window_id : windows.window_ids) {
+        // 前端在监听失效信号后才使用快速路径
+        windows.resolve(window_id)->watched = true;
+        int64_t id = slots.add(window_id);
+        slots.get(id)->window_id = window_id;
+        ids.push_back(id);
+    }
+
+    BenchResult result = bench_run(name, iterations, count, [&]() {
+        for (int64_t id : ids) {
+            WindowSlot* slot = slots.get(id);
+            WindowRecord* record = windows.manager.find(slot->window_id, slot->owner_id);
+            bench_do_not_optimize(record && record->watched ? record : nullptr);
+        }
+    });
+    result.extra.push_back(std::make_pair("windows", (double)count));
+    return result;
+}
+
+// 单个调用：每个窗口各自解析并提交一次（与逐个调用hide(window)相同）
+static BenchResult bench_single(const std::string& name, size_t count, uint64_t iterations, bool taskbar) {
+    BenchWindows windows(count);
+    bool state = false;
+    uint64_t runs = 0;
+    BenchResult result = bench_run(name, iterations, count, [&]() {
+        // 每次迭代切换目标状态，保证每次都真正写入样式
+        state = !state;
+        runs++;
+        WindowStyleRequest request = taskbar ? taskbar_request(state) : clickable_request(state);
+        for (uint32_t window_id : windows.window_ids) {
+            WindowRecord* record = windows.resolve(window_id);
+            bench_do_not_optimize(windows.manager.apply(&record, &request, 1));
+        }
+    });
+    result.extra.push_back(std::make_pair("windows", (double)count));
+    result.extra.push_back(std::make_pair("backend_batches_per_iteration", (double)windows.backend->get_counters().batches / runs));
+    return result;
+}
+
+// 批量：所有窗口合并为一批，后端只调用一次（与hide_many相同）
+static BenchResult bench_batched(const std::string& name, size_t count, uint64_t iterations, bool taskbar) {
+    BenchWindows windows(count);
+    WindowStyleBatch batch;
+    bool state = false;
+    BenchResult result = bench_run(name, iterations, count, [&]() {
+        state = !state;
+        WindowStyleRequest request = taskbar ? taskbar_request(state) : clickable_request(state);
+        batch.clear();
+        for (uint32_t window_id : windows.window_ids) {
+            batch.add(windows.resolve(window_id), request);
+        }
+        bench_do_not_optimize(windows.manager.apply(batch));
+    });
+    result.extra.push_back(std::make_pair("windows", (double)count));
+    return result;
+}
+
+// 队列模式：逐个记录目标状态，最后一次commit
+static BenchResult bench_queued(const std::string& name, size_t count, uint64_t iterations) {
+    BenchWindows windows(count);
+    bool state = false;
+    BenchResult result = bench_run(name, iterations, count, [&]() {
+        state = !state;
+        WindowStyleRequest request = taskbar_request(state);
+        for (uint32_t window_id : windows.window_ids) {
+            windows.manager.queue(*windows.resolve(window_id), request);
+        }
+        bench_do_not_optimize(windows.manager.commit());
+    });
+    result.extra.push_back(std::make_pair("windows", (double)count));
+    return result;
+}
+
+// 重复请求：窗口已经处于目标状态，只比较影子状态
+static BenchResult bench_redundant(const std::string& name, size_t count, uint64_t iterations) {
+    BenchWindows windows(count);
+    WindowStyleRequest request = taskbar_request(false);
+    for (uint32_t window_id : windows.window_ids) {
+        WindowRecord* record = windows.resolve(window_id);
+        windows.manager.apply(&record, &request, 1);
+    }
+    windows.backend->reset_counters();
+
+    BenchResult result = bench_run(name, iterations, count, [&]() {
+        for (uint32_t window_id : windows.window_ids) {
+            WindowRecord* record = windows.resolve(window_id);
+            bench_do_not_optimize(windows.manager.apply(&record, &request, 1));
+        }
+    });
+    result.extra.push_back(std::make_pair("windows", (double)count));
+    result.extra.push_back(std::make_pair("style_writes", (double)windows.backend->get_counters().style_writes));
+    return result;
+}
+
+static BenchResult bench_is_visible(const std::string& name, size_t count, uint64_t iterations) {
+    BenchWindows windows(count);
+    BenchResult result = bench_run(name, iterations, count, [&]() {
+        for (uint32_t window_id : windows.window_ids) {
+            WindowRecord* record = windows.resolve(window_id);
+            bool visible = record && windows.manager.load_style(*record) && WindowStyleManager::is_taskbar_visible(record->style);
+            bench_do_not_optimize(visible);
+        }
+    });
+    result.extra.push_back(std::make_pair("windows", (double)count));
+    result.extra.push_back(std::make_pair("style_reads", (double)windows.backend->get_counters().style_reads));
+    return result;
+}
+
+// 句柄解析：缓存命中，以及每次清空缓存后重新查找
+static BenchResult bench_resolve(const std::string& name, size_t count, uint64_t iterations, bool cached) {
+    BenchWindows windows(count);
+    BenchResult result = bench_run_setup(name, iterations, count, [&]() {
+        if (!cached) {
+            windows.manager.clear();
+        }
+    }, [&]() {
+        for (uint32_t window_id : windows.window_ids) {
+            bench_do_not_optimize(windows.resolve(window_id));
+        }
+    });
+    result.extra.push_back(std::make_pair("windows", (double)count));
+    return result;
+}
+
+// 异步：提交全部窗口后等待所有结果返回（提交到完成的总时间）
+static BenchResult bench_async(const std::string& name, size_t count, uint64_t iterations) {
+    BenchWindows windows(count);
+    std::recursive_mutex mutex;
+    WindowExecutor executor(windows.manager, mutex);
+    executor.start();
+
+    bool state = false;
+    uint64_t runs = 0;
+    uint64_t submit_ns = 0;
+    BenchResult result = bench_run(name, iterations, count, [&]() {
+        state = !state;
+        runs++;
+        WindowStyleRequest request = taskbar_request(state);
+        uint64_t start = bench_now_ns();
+        for (uint32_t window_id : windows.window_ids) {
+            executor.submit(window_id, window_id, request);
+        }
+        submit_ns += bench_now_ns() - start;
+
+        size_t received = 0;
+        WindowCommandResult command_result;
+        while (received < count) {
+            if (executor.poll_result(command_result)) {
+                received++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    executor.stop();
+
+    result.extra.push_back(std::make_pair("windows", (double)count));
+    // 调用线程上的开销（只包含入队）
+    result.extra.push_back(std::make_pair("submit_ns_per_op", (double)submit_ns / (runs * count)));
+    result.extra.push_back(std::make_pair("backend_batches_per_iteration", (double)windows.backend->get_counters().batches / runs));
+    return result;
+}
+
+int main(int argc, char** argv) {
+    uint64_t iterations = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000;
+    const size_t counts[] = { 1, 10, 100 };
+    std::vector<BenchResult> results;
+
+    for (size_t count : counts) {
+        std::string suffix = "_" + std::to_string(count);
+        results.push_back(bench_resolve("resolve_cached" + suffix, count, iterations, true));
+        results.push_back(bench_resolve("resolve_uncached" + suffix, count, iterations, false));
+        results.push_back(bench_resolve_slot("resolve_slot" + suffix, count, iterations));
+        results.push_back(bench_single("hide_show_single" + suffix, count, iterations, true));
+        results.push_back(bench_batched("hide_show_batched" + suffix, count, iterations, true));
+        results.push_back(bench_queued("hide_show_queued" + suffix, count, iterations));
+        results.push_back(bench_redundant("hide_redundant" + suffix, count, iterations));
+        results.push_back(bench_is_visible("is_visible" + suffix, count, iterations));
+        results.push_back(bench_single("set_clickable_single" + suffix, count, iterations, false));
+        results.push_back(bench_batched("set_clickable_batched" + suffix, count, iterations, false));
+        results.push_back(bench_async("hide_show_async" + suffix, count, iterations));
+    }
+
+    bench_print_json("window_ops", results);
+    return 0;
+}
@@ -0,0 +1,441 @@
+// 端到端延迟测试（X11）：从调用扩展的样式接口到窗口管理器状态实际生效的时间
+// 用原始X11程序代替Godot创建窗口，经WindowStyleManager + X11后端隐藏任务栏/设置鼠标穿透，
+// 再用另一个独立连接（相当于任务栏或合成器）观察_NET_WM_STATE与XShape输入区域何时可见。
+// 每次迭代从第一次调用开始计时，到所有窗口的变更都被观察到为止；window_p50/p99为单个窗口的生效时间。
+// hide_unmapped_*为未映射（已创建但尚未显示）的窗口：窗口管理器不处理这类窗口的_NET_WM_STATE消息，
+// 后端直接改写属性，超时数不为0说明变更被丢掉了。
+// 需要X服务器与EWMH窗口管理器，一般通过 bench/run_x11_e2e.sh 在Xvfb下运行。
+// 用法：bin/bench_x11_e2e [iterations] [--wait-wm]
+
+#include "bench_common.h"
+#include "window_executor.h"
+#include "window_style_manager.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/shape.h>
+
+#include <poll.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// 等待单个变更生效的上限，超时计入timeouts
+static const uint64_t OBSERVE_TIMEOUT_NS = 2000000000ull;
+
+enum ObserveKind {
+    OBSERVE_TASKBAR,
+    OBSERVE_CLICKABLE,
+};
+
+// 被测窗口与观察者
+// display相当于Godot自己的连接（创建并拥有窗口），observer只读取状态并接收通知。
+class X11Host {
+public:
+    ~X11Host() { close(); }
+
+    bool open() {
+        display = XOpenDisplay(nullptr);
+        observer = XOpenDisplay(nullptr);
+        if (!display || !observer) {
+            return false;
+        }
+        int shape_error = 0;
+        if (!XShapeQueryExtension(observer, &shape_event_base, &shape_error)) {
+            return false;
+        }
+
+        const char* names[] = {
+            "_NET_WM_STATE",
+            "_NET_WM_STATE_SKIP_TASKBAR",
+            "_NET_SUPPORTING_WM_CHECK",
+        };
+        Atom atoms[3];
+        XInternAtoms(observer, (char**)names, 3, False, atoms);
+        atom_wm_state = atoms[0];
+        atom_skip_taskbar = atoms[1];
+        atom_supporting_wm = atoms[2];
+        return true;
+    }
+
+    void close() {
+        if (display) {
+            for (Window window : windows) {
+                XDestroyWindow(display, window);
+            }
+            XCloseDisplay(display);
+            display = nullptr;
+        }
+        if (observer) {
+            XCloseDisplay(observer);
+            observer = nullptr;
+        }
+        windows.clear();
+        indices.clear();
+    }
+
+    bool has_window_manager() {
+        Atom type = None;
+        int format = 0;
+        unsigned long count = 0;
+        unsigned long remaining = 0;
+        unsigned char* data = nullptr;
+        int status = XGetWindowProperty(observer, DefaultRootWindow(observer), atom_supporting_wm, 0, 1, False,
+                                        AnyPropertyType, &type, &format, &count, &remaining, &data);
+        if (data) {
+            XFree(data);
+        }
+        return status == Success && count > 0;
+    }
+
+    bool wait_window_manager(uint64_t timeout_ns) {
+        uint64_t deadline = bench_now_ns() + timeout_ns;
+        while (!has_window_manager()) {
+            if (bench_now_ns() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        return true;
+    }
+
+    // 创建窗口，map为true时映射并等待全部映射完成（有窗口管理器时映射由它完成）
+    bool create_windows(size_t count, bool map = true) {
+        Window root = DefaultRootWindow(display);
+        for (size_t i = 0; i < count; i++) {
+            int x = (int)(i % 10) * 60;
+            int y = (int)(i / 10) * 60;
+            Window window = XCreateSimpleWindow(display, root, x, y, 50, 50, 0, 0, 0);
+            XSelectInput(display, window, StructureNotifyMask);
+            XStoreName(display, window, "bench_x11_e2e");
+            if (map) {
+                XMapWindow(display, window);
+            }
+            indices[window] = windows.size();
+            windows.push_back(window);
+        }
+        XFlush(display);
+
+        size_t mapped = map ? 0 : count;
+        uint64_t deadline = bench_now_ns() + OBSERVE_TIMEOUT_NS * 5;
+        while (mapped < count && bench_now_ns() < deadline) {
+            if (!wait_readable(display, deadline)) {
+                continue;
+            }
+            while (XPending(display)) {
+                XEvent event;
+                XNextEvent(display, &event);
+                if (event.type == MapNotify && indices.count(event.xmap.window)) {
+                    mapped++;
+                }
+            }
+        }
+
+        // 观察者订阅属性与输入区域的变化
+        for (Window window : windows) {
+            XSelectInput(observer, window, PropertyChangeMask);
+            XShapeSelectInput(observer, window, ShapeNotifyMask);
+        }
+        XSync(observer, True);
+        return mapped == count;
+    }
+
+    // 丢弃拥有者连接上积压的事件（窗口管理器的ConfigureNotify等）
+    void drain_host_events() {
+        while (XPending(display)) {
+            XEvent event;
+            XNextEvent(display, &event);
+        }
+    }
+
+    // 等待所有窗口达到目标状态，返回是否全部观察到；r_window_ns为各窗口相对start_ns的生效时间
+    // check_now为true时先直接读取一次当前状态（用于复位，目标可能已经生效）
+    bool wait_observed(ObserveKind kind, bool target, uint64_t start_ns, std::vector<uint64_t>& r_window_ns, bool check_now = false) {
+        std::vector<bool> done(windows.size(), false);
+        size_t remaining = windows.size();
+        r_window_ns.assign(windows.size(), 0);
+
+        if (check_now) {
+            for (size_t i = 0; i < windows.size(); i++) {
+                if (read_state(kind, windows[i]) == target) {
+                    done[i] = true;
+                    remaining--;
+                }
+            }
+        }
+
+        uint64_t deadline = bench_now_ns() + OBSERVE_TIMEOUT_NS;
+        while (remaining > 0) {
+            if (!XPending(observer) && !wait_readable(observer, deadline)) {
+                if (bench_now_ns() > deadline) {
+                    return false;
+                }
+                continue;
+            }
+            while (remaining > 0 && XPending(observer)) {
+                XEvent event;
+                XNextEvent(observer, &event);
+
+                Window window = None;
+                if (kind == OBSERVE_TASKBAR && event.type == PropertyNotify && event.xproperty.atom == atom_wm_state) {
+                    window = event.xproperty.window;
+                } else if (kind == OBSERVE_CLICKABLE && event.type == shape_event_base + ShapeNotify) {
+                    XShapeEvent* shape = (XShapeEvent*)&event;
+                    if (shape->kind == ShapeInput) {
+                        window = shape->window;
+                    }
+                }
+                auto it = indices.find(window);
+                if (it == indices.end() || done[it->second]) {
+                    continue;
+                }
+
+                // 通知可能来自上一轮或窗口管理器的其他修改，以实际读到的状态为准
+                if (read_state(kind, window) == target) {
+                    done[it->second] = true;
+                    r_window_ns[it->second] = bench_now_ns() - start_ns;
+                    remaining--;
+                }
+            }
+        }
+        return true;
+    }
+
+    Display* get_display() const { return display; }
+    const std::vector<Window>& get_windows() const { return windows; }
+
+    static NativeWindowHandle lookup_handle(uint32_t window_id, void* userdata) {
+        X11Host* host = (X11Host*)userdata;
+        if (window_id == 0 || window_id > host->windows.size()) {
+            return 0;
+        }
+        return (NativeWindowHandle)host->windows[window_id - 1];
+    }
+
+private:
+    Display* display = nullptr;
+    Display* observer = nullptr;
+    int shape_event_base = 0;
+    Atom atom_wm_state = None;
+    Atom atom_skip_taskbar = None;
+    Atom atom_supporting_wm = None;
+    std::vector<Window> windows;
+    std::unordered_map<Window, size_t> indices;
+
+    static bool wait_readable(Display* connection, uint64_t deadline) {
+        uint64_t now = bench_now_ns();
+        if (now >= deadline) {
+            return false;
+        }
+        struct pollfd fd = {};
+        fd.fd = ConnectionNumber(connection);
+        fd.events = POLLIN;
+        int timeout_ms = (int)std::min<uint64_t>((deadline - now) / 1000000 + 1, 100);
+        return poll(&fd, 1, timeout_ms) > 0;
+    }
+
+    // 任务栏：是否带SKIP_TASKBAR（即已隐藏）；穿透：输入区域是否为空
+    bool read_state(ObserveKind kind, Window window) {
+        if (kind == OBSERVE_CLICKABLE) {
+            int count = 0;
+            int ordering = 0;
+            XRectangle* rects = XShapeGetRectangles(observer, window, ShapeInput, &count, &ordering);
+            if (rects) {
+                XFree(rects);
+            }
+            return count == 0;
+        }
+
+        Atom type = None;
+        int format = 0;
+        unsigned long count = 0;
+        unsigned long remaining = 0;
+        unsigned char* data = nullptr;
+        bool skip = false;
+        if (XGetWindowProperty(observer, window, atom_wm_state, 0, 64, False, XA_ATOM,
+                               &type, &format, &count, &remaining, &data) == Success && data) {
+            Atom* atoms = (Atom*)data;
+            for (unsigned long i = 0; i < count; i++) {
+                skip = skip || atoms[i] == atom_skip_taskbar;
+            }
+        }
+        if (data) {
+            XFree(data);
+        }
+        return skip;
+    }
+};
+
+enum SubmitMode {
+    SUBMIT_SINGLE,   // 每个窗口单独调用（逐个hide(window)）
+    SUBMIT_BATCHED,  // 一批提交（hide_many）
+    SUBMIT_ASYNC,    // 异步执行器（hide_async）
+};
+
+static WindowStyleRequest make_request(ObserveKind kind, bool target) {
+    WindowStyleRequest request;
+    if (kind == OBSERVE_TASKBAR) {
+        request.set_taskbar = true;
+        request.taskbar_visible = !target;
+    } else {
+        request.set_clickable = true;
+        request.clickable = !target;
+    }
+    return request;
+}
+
+static double percentile(std::vector<uint64_t>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return (double)samples[std::min(samples.size() - 1, (size_t)(samples.size() * p))];
+}
+
+static BenchResult bench_case(X11Host& host, const std::string& name, ObserveKind kind, SubmitMode mode, uint64_t iterations) {
+    const std::vector<Window>& windows = host.get_windows();
+    size_t count = windows.size();
+
+    WindowStyleManager manager;
+    manager.set_backend(create_x11_window_backend());
+    manager.set_handle_lookup(X11Host::lookup_handle, &host);
+    std::recursive_mutex manager_mutex;
+    WindowExecutor executor(manager, manager_mutex);
+    if (mode == SUBMIT_ASYNC) {
+        executor.start();
+    }
+
+    std::vector<uint32_t> window_ids;
+    for (size_t i = 0; i < count; i++) {
+        window_ids.push_back((uint32_t)i + 1);
+    }
+
+    auto submit = [&](bool target) {
+        WindowStyleRequest request = make_request(kind, target);
+        if (mode == SUBMIT_ASYNC) {
+            for (uint32_t window_id : window_ids) {
+                executor.submit(window_id, window_id, request);
+            }
+            return;
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        if (mode == SUBMIT_SINGLE) {
+            for (uint32_t window_id : window_ids) {
+                WindowRecord* record = manager.resolve(window_id, window_id);
+                manager.apply(&record, &request, 1);
+            }
+        } else {
+            WindowStyleBatch batch;
+            for (uint32_t window_id : window_ids) {
+                batch.add(manager.resolve(window_id, window_id), request);
+            }
+            manager.apply(batch);
+        }
+    };
+
+    // 复位到未隐藏/可点击，之后每次迭代切换
+    std::vector<uint64_t> window_ns;
+    submit(false);
+    host.wait_observed(kind, false, bench_now_ns(), window_ns, true);
+
+    bool target = false;
+    uint64_t timeouts = 0;
+    std::vector<uint64_t> window_samples;
+    BenchResult result = bench_run_setup(name, iterations, count, [&]() {
+        // 取回上一轮的异步结果，清掉拥有者连接上的事件
+        WindowCommandResult command_result;
+        while (executor.get_completed() < executor.get_submitted()) {
+            std::this_thread::yield();
+        }
+        while (executor.poll_result(command_result)) {
+        }
+        host.drain_host_events();
+    }, [&]() {
+        target = !target;
+        uint64_t start = bench_now_ns();
+        submit(target);
+        if (!host.wait_observed(kind, target, start, window_ns)) {
+            timeouts++;
+            // 影子状态可能与实际不符，重新读取
+            std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+            manager.resync_all();
+            return;
+        }
+        window_samples.insert(window_samples.end(), window_ns.begin(), window_ns.end());
+    });
+
+    executor.stop();
+
+    result.extra.push_back(std::make_pair("windows", (double)count));
+    result.extra.push_back(std::make_pair("window_p50_ns", percentile(window_samples, 0.5)));
+    result.extra.push_back(std::make_pair("window_p99_ns", percentile(window_samples, 0.99)));
+    result.extra.push_back(std::make_pair("timeouts", (double)timeouts));
+    return result;
+}
+
+int main(int argc, char** argv) {
+    uint64_t iterations = 200;
+    bool wait_wm = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--wait-wm") == 0) {
+            wait_wm = true;
+        } else {
+            iterations = strtoull(argv[i], nullptr, 10);
+        }
+    }
+
+    const size_t counts[] = { 1, 10, 100 };
+    const SubmitMode modes[] = { SUBMIT_SINGLE, SUBMIT_BATCHED, SUBMIT_ASYNC };
+    const char* mode_names[] = { "single", "batched", "async" };
+    std::vector<BenchResult> results;
+    bool has_wm = false;
+
+    for (size_t count : counts) {
+        X11Host host;
+        if (!host.open()) {
+            fprintf(stderr, "bench_x11_e2e: cannot open display or XShape is missing\n");
+            return 1;
+        }
+        if (wait_wm && !host.wait_window_manager(OBSERVE_TIMEOUT_NS * 5)) {
+            fprintf(stderr, "bench_x11_e2e: no EWMH window manager (_NET_SUPPORTING_WM_CHECK)\n");
+            return 1;
+        }
+        has_wm = host.has_window_manager();
+        if (!host.create_windows(count)) {
+            fprintf(stderr, "bench_x11_e2e: windows were not mapped\n");
+            return 1;
+        }
+
+        std::string suffix = "_" + std::to_string(count);
+        for (int m = 0; m < 3; m++) {
+            results.push_back(bench_case(host, std::string("hide_") + mode_names[m] + suffix, OBSERVE_TASKBAR, modes[m], iterations));
+            results.push_back(bench_case(host, std::string("click_through_") + mode_names[m] + suffix, OBSERVE_CLICKABLE, modes[m], iterations));
+        }
+    }
+
+    // 未映射的窗口：只测任务栏，输入区域与映射状态无关
+    {
+        X11Host host;
+        if (!host.open() || !host.create_windows(10, false)) {
+            fprintf(stderr, "bench_x11_e2e: cannot create unmapped windows\n");
+            return 1;
+        }
+        for (int m = 0; m < 3; m++) {
+            results.push_back(bench_case(host, std::string("hide_unmapped_") + mode_names[m] + "_10", OBSERVE_TASKBAR, modes[m], iterations));
+        }
+    }
+
+    // 没有窗口管理器时后端直接改写属性，结果不代表真实桌面
+    BenchResult environment;
+    environment.name = "environment";
+    environment.extra.push_back(std::make_pair("window_manager", has_wm ? 1.0 : 0.0));
+    results.push_back(environment);
+
+    bench_print_json("x11_e2e", results);
+    return 0;
+}
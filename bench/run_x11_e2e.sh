@@ -0,0 +1,67 @@
+#!/bin/sh
+# 在无界面环境中运行端到端延迟测试：启动Xvfb与一个轻量的EWMH窗口管理器，再运行bin/bench_x11_e2e
+# 用法：bench/run_x11_e2e.sh [iterations]
+#   WM=openbox|fluxbox|icewm|xfwm4|none 指定窗口管理器（默认使用第一个找到的，none为不启动）
+#   有窗口管理器与没有窗口管理器时后端走不同的路径，两种都应运行一次（WM=none再运行一次）
+#   XDISPLAY=:99 指定虚拟显示编号
+# 依赖：xvfb，以及上面任一窗口管理器（Debian/Ubuntu：apt install xvfb openbox）
+
+set -e
+
+XDISPLAY=${XDISPLAY:-:99}
+BENCH=${BENCH:-bin/bench_x11_e2e}
+
+if [ ! -x "$BENCH" ]; then
+    echo "run_x11_e2e: $BENCH not found, build it with: scons bench" >&2
+    exit 1
+fi
+if ! command -v Xvfb >/dev/null 2>&1; then
+    echo "run_x11_e2e: Xvfb not found" >&2
+    exit 1
+fi
+
+if [ -z "$WM" ]; then
+    for candidate in openbox fluxbox icewm xfwm4; do
+        if command -v "$candidate" >/dev/null 2>&1; then
+            WM=$candidate
+            break
+        fi
+    done
+fi
+if [ -z "$WM" ]; then
+    echo "run_x11_e2e: no EWMH window manager found (set WM=none to run without one)" >&2
+    exit 1
+fi
+
+XVFB_PID=
+WM_PID=
+cleanup() {
+    [ -n "$WM_PID" ] && kill "$WM_PID" 2>/dev/null || true
+    [ -n "$XVFB_PID" ] && kill "$XVFB_PID" 2>/dev/null || true
+}
+trap cleanup EXIT INT TERM
+
+Xvfb "$XDISPLAY" -screen 0 1280x1024x24 -nolisten tcp +extension SHAPE >/dev/null 2>&1 &
+XVFB_PID=$!
+
+# 等待X服务器的套接字出现
+SOCKET=/tmp/.X11-unix/X${XDISPLAY#:}
+i=0
+while [ ! -S "$SOCKET" ]; do
+    i=$((i + 1))
+    if [ $i -gt 100 ]; then
+        echo "run_x11_e2e: Xvfb did not start" >&2
+        exit 1
+    fi
+    sleep 0.1
+done
+export DISPLAY=$XDISPLAY
+
+if [ "$WM" = "none" ]; then
+    "$BENCH" "$@"
+else
+    "$WM" >/dev/null 2>&1 &
+    WM_PID=$!
+    # 测试程序等待_NET_SUPPORTING_WM_CHECK出现后才开始
+    "$BENCH" --wait-wm "$@"
+fi
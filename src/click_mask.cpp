@@ -0,0 +1,375 @@
+#include "click_mask.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CLICK_MASK_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CLICK_MASK_NEON
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static inline int count_trailing_zeros(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (int)index;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// 行合并
+void MaskRectBuilder::begin() {
+    open.clear();
+    closed.clear();
+    row = 0;
+}
+
+void MaskRectBuilder::add_row(const MaskRun* runs, size_t count) {
+    // 上一行未关闭的矩形与本行区间都按x有序，双指针合并
+    next_open.clear();
+    size_t i = 0;
+    size_t j = 0;
+    while (i < open.size() || j < count) {
+        if (j == count || (i < open.size() && (open[i].x < runs[j].begin
+                || (open[i].x == runs[j].begin && open[i].width < runs[j].end - runs[j].begin)))) {
+            closed.push_back(open[i++]);
+        } else if (i < open.size() && open[i].x == runs[j].begin && open[i].width == runs[j].end - runs[j].begin) {
+            open[i].height++;
+            next_open.push_back(open[i]);
+            i++;
+            j++;
+        } else {
+            MaskRect rect;
+            rect.x = runs[j].begin;
+            rect.y = row;
+            rect.width = runs[j].end - runs[j].begin;
+            rect.height = 1;
+            next_open.push_back(rect);
+            j++;
+        }
+    }
+    open.swap(next_open);
+    row++;
+}
+
+void MaskRectBuilder::repeat_row() {
+    for (MaskRect& rect : open) {
+        rect.height++;
+    }
+    row++;
+}
+
+void MaskRectBuilder::finish(std::vector<MaskRect>& r_rects) {
+    r_rects.clear();
+    r_rects.reserve(closed.size() + open.size());
+    r_rects.insert(r_rects.end(), closed.begin(), closed.end());
+    r_rects.insert(r_rects.end(), open.begin(), open.end());
+    open.clear();
+    closed.clear();
+}
+
+// 阈值化
+// 每次处理16个像素得到16位掩码，凑满64个像素写入一个字。
+#if defined(CLICK_MASK_SSE2)
+static inline __m128i load_alpha_16(const uint8_t* p, ClickMaskFormat format) {
+    __m128i alpha;
+    if (format == CLICK_MASK_RGBA8) {
+        // 每个32位像素右移24位得到透明度，再两次饱和打包成16个字节
+        __m128i a0 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(p + 0)), 24);
+        __m128i a1 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(p + 16)), 24);
+        __m128i a2 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(p + 32)), 24);
+        __m128i a3 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(p + 48)), 24);
+        alpha = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+    } else if (format == CLICK_MASK_LA8) {
+        __m128i a0 = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(p + 0)), 8);
+        __m128i a1 = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(p + 16)), 8);
+        alpha = _mm_packus_epi16(a0, a1);
+    } else {
+        alpha = _mm_loadu_si128((const __m128i*)p);
+    }
+    return alpha;
+}
+
+static inline uint32_t threshold_16(const uint8_t* p, ClickMaskFormat format, __m128i threshold) {
+    __m128i alpha = load_alpha_16(p, format);
+    // 无符号比较：alpha >= t 等价于 max(alpha, t) == alpha
+    __m128i ge = _mm_cmpeq_epi8(_mm_max_epu8(alpha, threshold), alpha);
+    return (uint32_t)_mm_movemask_epi8(ge);
+}
+#elif defined(CLICK_MASK_NEON)
+static inline uint8x16_t load_alpha_16(const uint8_t* p, ClickMaskFormat format) {
+    if (format == CLICK_MASK_RGBA8) {
+        return vld4q_u8(p).val[3];
+    } else if (format == CLICK_MASK_LA8) {
+        return vld2q_u8(p).val[1];
+    }
+    return vld1q_u8(p);
+}
+
+static inline uint32_t threshold_16(const uint8_t* p, ClickMaskFormat format, uint8x16_t threshold) {
+    uint8x16_t alpha = load_alpha_16(p, format);
+    // 每个字节与位权重相与后横向求和，得到16位掩码
+    static const uint8_t weights_data[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t bits = vandq_u8(vcgeq_u8(alpha, threshold), vld1q_u8(weights_data));
+    return (uint32_t)vaddv_u8(vget_low_u8(bits)) | ((uint32_t)vaddv_u8(vget_high_u8(bits)) << 8);
+}
+#endif
+
+void ClickMask::threshold_row(const uint8_t* row, int32_t width, ClickMaskFormat format,
+                              uint8_t threshold, uint64_t* r_bits) {
+    const int32_t bytes_per_pixel = format == CLICK_MASK_RGBA8 ? 4 : (format == CLICK_MASK_LA8 ? 2 : 1);
+    const int32_t alpha_offset = bytes_per_pixel - 1;
+    int32_t x = 0;
+
+#if defined(CLICK_MASK_SSE2) || defined(CLICK_MASK_NEON)
+#if defined(CLICK_MASK_SSE2)
+    const __m128i threshold_vec = _mm_set1_epi8((char)threshold);
+#else
+    const uint8x16_t threshold_vec = vdupq_n_u8(threshold);
+#endif
+    for (; x + 64 <= width; x += 64) {
+        const uint8_t* p = row + (size_t)x * bytes_per_pixel;
+        uint64_t word = (uint64_t)threshold_16(p, format, threshold_vec);
+        word |= (uint64_t)threshold_16(p + 16 * bytes_per_pixel, format, threshold_vec) << 16;
+        word |= (uint64_t)threshold_16(p + 32 * bytes_per_pixel, format, threshold_vec) << 32;
+        word |= (uint64_t)threshold_16(p + 48 * bytes_per_pixel, format, threshold_vec) << 48;
+        r_bits[x >> 6] = word;
+    }
+#endif
+
+    // 剩余像素（以及没有SIMD时的全部像素）逐个处理，最后一个字的多余位保持为0
+    for (; x < width; x += 64) {
+        int32_t count = std::min(64, width - x);
+        const uint8_t* p = row + (size_t)x * bytes_per_pixel + alpha_offset;
+        uint64_t word = 0;
+        for (int32_t i = 0; i < count; i++) {
+            word |= (uint64_t)(p[(size_t)i * bytes_per_pixel] >= threshold) << i;
+        }
+        r_bits[x >> 6] = word;
+    }
+}
+
+void ClickMask::extract_alpha(const uint8_t* pixels, int32_t width, int32_t height, size_t stride,
+                              ClickMaskFormat format, uint8_t* r_alpha) {
+    const int32_t bytes_per_pixel = format == CLICK_MASK_RGBA8 ? 4 : (format == CLICK_MASK_LA8 ? 2 : 1);
+    const int32_t alpha_offset = bytes_per_pixel - 1;
+    for (int32_t y = 0; y < height; y++) {
+        const uint8_t* row = pixels + stride * y;
+        uint8_t* out = r_alpha + (size_t)width * y;
+        int32_t x = 0;
+#if defined(CLICK_MASK_SSE2)
+        for (; x + 16 <= width; x += 16) {
+            _mm_storeu_si128((__m128i*)(out + x), load_alpha_16(row + (size_t)x * bytes_per_pixel, format));
+        }
+#elif defined(CLICK_MASK_NEON)
+        for (; x + 16 <= width; x += 16) {
+            vst1q_u8(out + x, load_alpha_16(row + (size_t)x * bytes_per_pixel, format));
+        }
+#endif
+        for (; x < width; x++) {
+            out[x] = row[(size_t)x * bytes_per_pixel + alpha_offset];
+        }
+    }
+}
+
+void ClickMask::extract_runs(const uint64_t* bits, int32_t width, std::vector<MaskRun>& r_runs) {
+    r_runs.clear();
+    const int32_t words = (width + 63) >> 6;
+    int32_t w = 0;
+    uint64_t word = words > 0 ? bits[0] : 0;
+    bool inside = false;
+    MaskRun run;
+
+    // 在当前字中交替寻找下一个1（区间开始）和下一个0（区间结束）
+    while (w < words) {
+        uint64_t pending = inside ? ~word : word;
+        if (pending == 0) {
+            w++;
+            if (w < words) {
+                word = bits[w];
+            }
+            continue;
+        }
+
+        int32_t bit = count_trailing_zeros(pending);
+        int32_t x = (w << 6) + bit;
+        if (x >= width) {
+            break;
+        }
+
+        if (inside) {
+            run.end = x;
+            r_runs.push_back(run);
+        } else {
+            run.begin = x;
+        }
+        inside = !inside;
+
+        // 把当前位之前的位翻转为与新状态相反，使下一次查找从这里继续
+        uint64_t below = bit == 63 ? ~0ull : ((1ull << (bit + 1)) - 1);
+        word = inside ? (word | below) : (word & ~below);
+    }
+
+    if (inside) {
+        run.end = width;
+        r_runs.push_back(run);
+    }
+}
+
+void ClickMask::reset() {
+    valid = false;
+    has_rects = false;
+    changed_rows = 0;
+    rects.clear();
+}
+
+void ClickMask::build(const uint8_t* pixels, int32_t p_width, int32_t p_height, size_t stride,
+                      ClickMaskFormat p_format, uint8_t p_threshold) {
+    reset();
+    update(pixels, p_width, p_height, stride, p_format, p_threshold);
+}
+
+static inline bool same_runs(const std::vector<MaskRun>& a, const std::vector<MaskRun>& b) {
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(MaskRun)) == 0);
+}
+
+bool ClickMask::update(const uint8_t* pixels, int32_t p_width, int32_t p_height, size_t stride,
+                       ClickMaskFormat p_format, uint8_t p_threshold, const MaskRect* dirty) {
+    p_width = std::max(0, p_width);
+    p_height = std::max(0, p_height);
+
+    // 与上一次不可比较时完整重建
+    bool full = !valid || p_width != width || p_height != height || p_format != format || p_threshold != threshold;
+    if (full) {
+        width = p_width;
+        height = p_height;
+        format = p_format;
+        threshold = p_threshold;
+        words_per_row = (size_t)(width + 63) >> 6;
+        bits.assign(words_per_row * height, 0);
+        row_runs.resize(height);
+        for (std::vector<MaskRun>& row : row_runs) {
+            row.clear();
+        }
+        valid = true;
+    }
+
+    // 脏区域按64像素对齐到整字，行范围裁剪到图像内
+    int32_t y0 = 0;
+    int32_t y1 = height;
+    int32_t x0 = 0;
+    int32_t x1 = width;
+    if (dirty && !full) {
+        y0 = std::max(0, dirty->y);
+        y1 = std::min(height, dirty->y + dirty->height);
+        x0 = std::max(0, dirty->x) & ~63;
+        x1 = std::min(width, ((dirty->x + dirty->width + 63) & ~63));
+    }
+    changed_rows = 0;
+    if (y0 >= y1 || x0 >= x1) {
+        return false;
+    }
+
+    const int32_t bytes_per_pixel = format == CLICK_MASK_RGBA8 ? 4 : (format == CLICK_MASK_LA8 ? 2 : 1);
+    const size_t word_begin = (size_t)x0 >> 6;
+    const size_t word_count = ((size_t)x1 + 63) / 64 - word_begin;
+    row_scratch.resize(word_count);
+
+    for (int32_t y = y0; y < y1; y++) {
+        uint64_t* row_bits = bits.data() + words_per_row * y + word_begin;
+        threshold_row(pixels + stride * y + (size_t)x0 * bytes_per_pixel, x1 - x0, format, threshold, row_scratch.data());
+        if (!full && memcmp(row_scratch.data(), row_bits, word_count * sizeof(uint64_t)) == 0) {
+            continue;
+        }
+        memcpy(row_bits, row_scratch.data(), word_count * sizeof(uint64_t));
+        changed_rows++;
+
+        // 与上一行位集相同时直接复用区间
+        const uint64_t* full_row = bits.data() + words_per_row * y;
+        if (y > 0 && memcmp(full_row, full_row - words_per_row, words_per_row * sizeof(uint64_t)) == 0) {
+            row_runs[y] = row_runs[y - 1];
+        } else {
+            extract_runs(full_row, width, row_runs[y]);
+        }
+    }
+
+    // 位集没有变化时点击区域一定不变
+    if (changed_rows == 0 && !full) {
+        return false;
+    }
+    rebuild_rects();
+    has_rects = true;
+    return true;
+}
+
+void ClickMask::rebuild_rects() {
+    // 合并只遍历每行缓存的区间，与上一行相同的行直接延长矩形
+    builder.begin();
+    for (int32_t y = 0; y < height; y++) {
+        if (y > 0 && same_runs(row_runs[y], row_runs[y - 1])) {
+            builder.repeat_row();
+        } else {
+            builder.add_row(row_runs[y].data(), row_runs[y].size());
+        }
+    }
+    builder.finish(rects);
+}
+
+bool ClickMask::build_polygon(const float* points, size_t point_count, int32_t p_width, int32_t p_height) {
+    // 多边形不保存位集，之后的update一定完整重建
+    bool had_rects = has_rects;
+    valid = false;
+    has_rects = true;
+    width = std::max(0, p_width);
+    height = std::max(0, p_height);
+    changed_rows = 0;
+    previous_rects.swap(rects);
+
+    std::vector<float> crossings;
+    builder.begin();
+    for (int32_t y = 0; y < height; y++) {
+        // 扫描线取像素中心
+        float sample_y = (float)y + 0.5f;
+        crossings.clear();
+        for (size_t i = 0; i < point_count; i++) {
+            const float* a = points + i * 2;
+            const float* b = points + ((i + 1) % point_count) * 2;
+            if ((a[1] <= sample_y) != (b[1] <= sample_y)) {
+                float t = (sample_y - a[1]) / (b[1] - a[1]);
+                crossings.push_back(a[0] + t * (b[0] - a[0]));
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        runs.clear();
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+            // 像素中心落在 [x0, x1) 内的像素
+            MaskRun run;
+            run.begin = std::max(0, (int32_t)std::ceil(crossings[i] - 0.5f));
+            run.end = std::min(width, (int32_t)std::ceil(crossings[i + 1] - 0.5f));
+            if (run.end <= run.begin) {
+                continue;
+            }
+            if (!runs.empty() && run.begin <= runs.back().end) {
+                runs.back().end = std::max(runs.back().end, run.end);
+            } else {
+                runs.push_back(run);
+            }
+        }
+        builder.add_row(runs.data(), runs.size());
+    }
+    builder.finish(rects);
+
+    // 矩形按相同顺序生成，逐个比较即可判断区域是否变化
+    return !had_rects || rects.size() != previous_rects.size()
+        || (!rects.empty() && memcmp(rects.data(), previous_rects.data(), rects.size() * sizeof(MaskRect)) != 0);
+}
@@ -0,0 +1,104 @@
+#ifndef CLICK_MASK_H
+#define CLICK_MASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 点击区域矩形（窗口左上角为原点，单位为像素）
+struct MaskRect {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+// 蒙版像素格式，只读取其中的透明度通道
+enum ClickMaskFormat {
+    CLICK_MASK_ALPHA8,  // 每像素1字节（L8/R8也按透明度处理）
+    CLICK_MASK_LA8,     // 每像素2字节，透明度在第2字节
+    CLICK_MASK_RGBA8,   // 每像素4字节，透明度在第4字节
+};
+
+// 一行中连续可点击像素的区间 [begin, end)
+struct MaskRun {
+    int32_t begin = 0;
+    int32_t end = 0;
+};
+
+// 按行合并相同区间，生成尽量少的矩形
+// 相邻两行区间完全相同时延长矩形高度，否则关闭旧矩形并开始新矩形。
+class MaskRectBuilder {
+public:
+    void begin();
+    void add_row(const MaskRun* runs, size_t count);
+    // 与上一行完全相同的行，直接延长所有未关闭的矩形
+    void repeat_row();
+    void finish(std::vector<MaskRect>& r_rects);
+
+private:
+    std::vector<MaskRect> open;
+    std::vector<MaskRect> next_open;
+    std::vector<MaskRect> closed;
+    int32_t row = 0;
+};
+
+// 透明度蒙版 → 可点击矩形列表
+// 先用SIMD把每行阈值化为位集（alpha >= threshold 置1），再从位集中提取区间并按行合并。
+// 保存上一次的位集与每行区间，动画蒙版逐帧调用update时只重新处理有变化的行。
+class ClickMask {
+public:
+    // 完整重建
+    void build(const uint8_t* pixels, int32_t width, int32_t height, size_t stride,
+               ClickMaskFormat format, uint8_t threshold);
+
+    // 增量更新：只重新阈值化dirty覆盖的部分（为空时为整张图），只对位集变化的行重新提取区间。
+    // 尺寸、格式或阈值变化时自动完整重建。返回点击区域是否变化。
+    bool update(const uint8_t* pixels, int32_t width, int32_t height, size_t stride,
+                ClickMaskFormat format, uint8_t threshold, const MaskRect* dirty = nullptr);
+
+    // 多边形内部为可点击区域（奇偶规则，按像素中心采样），超出width/height的部分被裁掉。
+    // 返回点击区域是否变化。
+    bool build_polygon(const float* points, size_t point_count, int32_t width, int32_t height);
+
+    // 丢弃保存的状态，下一次update一定视为变化
+    void reset();
+
+    const std::vector<MaskRect>& get_rects() const { return rects; }
+    int32_t get_width() const { return width; }
+    int32_t get_height() const { return height; }
+    // 上一次update中位集有变化的行数
+    int32_t get_changed_rows() const { return changed_rows; }
+
+    // 单行阈值化，r_bits需要 (width + 63) / 64 个字
+    static void threshold_row(const uint8_t* row, int32_t width, ClickMaskFormat format,
+                              uint8_t threshold, uint64_t* r_bits);
+    // 从位集中提取连续区间
+    static void extract_runs(const uint64_t* bits, int32_t width, std::vector<MaskRun>& r_runs);
+    // 只取出透明度通道，r_alpha为紧密排列的 width * height 字节（即ALPHA8格式）。
+    // RGBA8每像素4字节，阈值化受内存带宽限制（4K约32MB）；不变的蒙版转换一次后按ALPHA8提交，读取量只有1/4。
+    static void extract_alpha(const uint8_t* pixels, int32_t width, int32_t height, size_t stride,
+                              ClickMaskFormat format, uint8_t* r_alpha);
+
+private:
+    bool valid = false;      // 位集与每行区间可用于增量比较
+    bool has_rects = false;  // rects为最近一次生成的区域
+    int32_t width = 0;
+    int32_t height = 0;
+    ClickMaskFormat format = CLICK_MASK_RGBA8;
+    uint8_t threshold = 0;
+    size_t words_per_row = 0;
+    int32_t changed_rows = 0;
+
+    std::vector<uint64_t> bits;
+    std::vector<uint64_t> row_scratch;
+    std::vector<std::vector<MaskRun>> row_runs;
+    std::vector<MaskRun> runs;
+    std::vector<MaskRect> rects;
+    std::vector<MaskRect> previous_rects;
+    MaskRectBuilder builder;
+
+    void rebuild_rects();
+};
+
+#endif // CLICK_MASK_H
@@ -1,15 +1,89 @@
 #include "hide_taskbar_extension.h"
+#include "window_backend_fake.h"
+#include "trace.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/classes/display_server.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
 
 using namespace godot;
 
+// 通过DisplayServer查询窗口句柄，作为WindowStyleManager的默认句柄查询回调
+static NativeWindowHandle display_server_lookup(uint32_t window_id, void* userdata) {
+    DisplayServer* display_server = DisplayServer::get_singleton();
+    if (!display_server) {
+        return 0;
+    }
+    return display_server->window_get_native_handle(DisplayServer::HandleType::WINDOW_HANDLE, window_id);
+}
+
+// 事件中的窗口ID取自已经解析的记录，不为记录事件再调用一次get_window_id（跨边界调用）
+static uint32_t trace_record_id(const WindowRecord* record) {
+    return record ? record->window_id : TRACE_NO_WINDOW;
+}
+
+// 读取蒙版图像的像素：RGBA8/LA8/L8/R8直接使用，其他格式复制一份转换为RGBA8。成功返回nullptr，失败返回错误消息
+static const char* read_mask_image(const Ref<Image>& image, PackedByteArray& r_data, int32_t& r_width, int32_t& r_height,
+                                   ClickMaskFormat& r_format, int32_t& r_bytes_per_pixel) {
+    if (image.is_null() || image->is_empty()) {
+        return "Click-through mask image is empty";
+    }
+
+    Ref<Image> source = image;
+    r_format = CLICK_MASK_RGBA8;
+    r_bytes_per_pixel = 4;
+    switch (image->get_format()) {
+        case Image::FORMAT_RGBA8:
+            break;
+        case Image::FORMAT_LA8:
+            r_format = CLICK_MASK_LA8;
+            r_bytes_per_pixel = 2;
+            break;
+        case Image::FORMAT_L8:
+        case Image::FORMAT_R8:
+            r_format = CLICK_MASK_ALPHA8;
+            r_bytes_per_pixel = 1;
+            break;
+        default:
+            source.instantiate();
+            source->copy_from(image);
+            if (source->is_compressed()) {
+                source->decompress();
+            }
+            source->convert(Image::FORMAT_RGBA8);
+            break;
+    }
+
+    // 数据开头即为第0级mipmap
+    r_data = source->get_data();
+    r_width = source->get_width();
+    r_height = source->get_height();
+    if (r_data.size() < (int64_t)r_width * r_height * r_bytes_per_pixel) {
+        return "Click-through mask image has unsupported format";
+    }
+    return nullptr;
+}
+
 void HideTaskBarInWindowsSystem::_bind_methods() {
     ClassDB::bind_method(D_METHOD("hide", "window"), &HideTaskBarInWindowsSystem::hide);
     ClassDB::bind_method(D_METHOD("show", "window"), &HideTaskBarInWindowsSystem::show);
     ClassDB::bind_method(D_METHOD("is_visible", "window"), &HideTaskBarInWindowsSystem::is_visible);
-    
+
     // 主窗口相关方法
     ClassDB::bind_method(D_METHOD("hide_main_window"), &HideTaskBarInWindowsSystem::hide_main_window);
     ClassDB::bind_method(D_METHOD("show_main_window"), &HideTaskBarInWindowsSystem::show_main_window);
@@ -18,450 +92,2262 @@ void HideTaskBarInWindowsSystem::_bind_methods() {
     // 窗口是否可点击相关方法
     ClassDB::bind_method(D_METHOD("set_clickable", "window", "clickable"), &HideTaskBarInWindowsSystem::set_clickable);
     ClassDB::bind_method(D_METHOD("is_clickable", "window"), &HideTaskBarInWindowsSystem::is_clickable);
-    
+
+    // 点击区域蒙版
+    ClassDB::bind_method(D_METHOD("set_click_through_mask", "window", "image", "threshold", "dirty_rect"), &HideTaskBarInWindowsSystem::set_click_through_mask, DEFVAL(128), DEFVAL(Rect2i()));
+    ClassDB::bind_method(D_METHOD("set_click_through_polygon", "window", "polygon"), &HideTaskBarInWindowsSystem::set_click_through_polygon);
+    ClassDB::bind_method(D_METHOD("clear_click_through_mask", "window"), &HideTaskBarInWindowsSystem::clear_click_through_mask);
+    ClassDB::bind_method(D_METHOD("convert_click_mask", "image"), &HideTaskBarInWindowsSystem::convert_click_mask);
+
+    // 悬停穿透
+    ClassDB::bind_method(D_METHOD("set_hover_mask", "window", "image", "threshold"), &HideTaskBarInWindowsSystem::set_hover_mask, DEFVAL(128));
+    ClassDB::bind_method(D_METHOD("set_hover_polygon", "window", "polygon"), &HideTaskBarInWindowsSystem::set_hover_polygon);
+    ClassDB::bind_method(D_METHOD("clear_hover", "window"), &HideTaskBarInWindowsSystem::clear_hover);
+    ClassDB::bind_method(D_METHOD("set_hover_interval", "msec"), &HideTaskBarInWindowsSystem::set_hover_interval);
+    ClassDB::bind_method(D_METHOD("get_hover_interval"), &HideTaskBarInWindowsSystem::get_hover_interval);
+    ClassDB::bind_method(D_METHOD("poll_hover_events"), &HideTaskBarInWindowsSystem::poll_hover_events);
+    ClassDB::bind_method(D_METHOD("query_window_states", "windows"), &HideTaskBarInWindowsSystem::query_window_states, DEFVAL(Array()));
+
+    // 窗口ID
+    ClassDB::bind_method(D_METHOD("register_window", "window"), &HideTaskBarInWindowsSystem::register_window);
+    ClassDB::bind_method(D_METHOD("unregister_window", "id"), &HideTaskBarInWindowsSystem::unregister_window);
+    ClassDB::bind_method(D_METHOD("is_window_id_valid", "id"), &HideTaskBarInWindowsSystem::is_window_id_valid);
+    ClassDB::bind_method(D_METHOD("get_window_by_id", "id"), &HideTaskBarInWindowsSystem::get_window_by_id);
+    ClassDB::bind_method(D_METHOD("hide_id", "id"), &HideTaskBarInWindowsSystem::hide_id);
+    ClassDB::bind_method(D_METHOD("show_id", "id"), &HideTaskBarInWindowsSystem::show_id);
+    ClassDB::bind_method(D_METHOD("is_visible_id", "id"), &HideTaskBarInWindowsSystem::is_visible_id);
+    ClassDB::bind_method(D_METHOD("set_clickable_id", "id", "clickable"), &HideTaskBarInWindowsSystem::set_clickable_id);
+    ClassDB::bind_method(D_METHOD("is_clickable_id", "id"), &HideTaskBarInWindowsSystem::is_clickable_id);
+    ClassDB::bind_method(D_METHOD("set_opacity_id", "id", "opacity"), &HideTaskBarInWindowsSystem::set_opacity_id);
+    ClassDB::bind_method(D_METHOD("get_opacity_id", "id"), &HideTaskBarInWindowsSystem::get_opacity_id);
+    ClassDB::bind_method(D_METHOD("fade_id", "id", "opacity", "duration"), &HideTaskBarInWindowsSystem::fade_id);
+    ClassDB::bind_method(D_METHOD("cancel_fade_id", "id"), &HideTaskBarInWindowsSystem::cancel_fade_id);
+    ClassDB::bind_method(D_METHOD("set_click_through_mask_id", "id", "image", "threshold", "dirty_rect"), &HideTaskBarInWindowsSystem::set_click_through_mask_id, DEFVAL(128), DEFVAL(Rect2i()));
+    ClassDB::bind_method(D_METHOD("set_click_through_polygon_id", "id", "polygon"), &HideTaskBarInWindowsSystem::set_click_through_polygon_id);
+    ClassDB::bind_method(D_METHOD("clear_click_through_mask_id", "id"), &HideTaskBarInWindowsSystem::clear_click_through_mask_id);
+    ClassDB::bind_method(D_METHOD("set_hover_mask_id", "id", "image", "threshold"), &HideTaskBarInWindowsSystem::set_hover_mask_id, DEFVAL(128));
+    ClassDB::bind_method(D_METHOD("set_hover_polygon_id", "id", "polygon"), &HideTaskBarInWindowsSystem::set_hover_polygon_id);
+    ClassDB::bind_method(D_METHOD("clear_hover_id", "id"), &HideTaskBarInWindowsSystem::clear_hover_id);
+    ClassDB::bind_method(D_METHOD("query_window_states_by_id", "ids"), &HideTaskBarInWindowsSystem::query_window_states_by_id);
+    BIND_CONSTANT(STATE_VALID);
+    BIND_CONSTANT(STATE_TASKBAR_HIDDEN);
+    BIND_CONSTANT(STATE_CLICK_THROUGH);
+    BIND_CONSTANT(STATE_LAYERED);
+    BIND_CONSTANT(STATE_OPACITY_TRANSLUCENT);
+    BIND_CONSTANT(STATE_OPACITY_TRANSPARENT);
+    BIND_CONSTANT(STATE_OPACITY_MASK);
+
+    ClassDB::bind_method(D_METHOD("set_style_watch_enabled", "enabled"), &HideTaskBarInWindowsSystem::set_style_watch_enabled);
+    ClassDB::bind_method(D_METHOD("is_style_watch_enabled"), &HideTaskBarInWindowsSystem::is_style_watch_enabled);
+    ClassDB::bind_method(D_METHOD("set_auto_reassert", "enabled"), &HideTaskBarInWindowsSystem::set_auto_reassert);
+    ClassDB::bind_method(D_METHOD("is_auto_reassert"), &HideTaskBarInWindowsSystem::is_auto_reassert);
+    ClassDB::bind_method(D_METHOD("poll_style_changes"), &HideTaskBarInWindowsSystem::poll_style_changes);
+    ADD_SIGNAL(MethodInfo("window_style_changed", PropertyInfo(Variant::OBJECT, "window", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT, "Window"), PropertyInfo(Variant::BOOL, "taskbar_visible"), PropertyInfo(Variant::BOOL, "clickable")));
+
+    ClassDB::bind_method(D_METHOD("set_opacity", "window", "opacity"), &HideTaskBarInWindowsSystem::set_opacity);
+    ClassDB::bind_method(D_METHOD("get_opacity", "window"), &HideTaskBarInWindowsSystem::get_opacity);
+    ClassDB::bind_method(D_METHOD("fade", "window", "opacity", "duration"), &HideTaskBarInWindowsSystem::fade);
+    ClassDB::bind_method(D_METHOD("cancel_fade", "window"), &HideTaskBarInWindowsSystem::cancel_fade);
+    ClassDB::bind_method(D_METHOD("poll_fade_events"), &HideTaskBarInWindowsSystem::poll_fade_events);
+    ADD_SIGNAL(MethodInfo("fade_finished", PropertyInfo(Variant::OBJECT, "window", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT, "Window"), PropertyInfo(Variant::BOOL, "completed")));
+    ADD_SIGNAL(MethodInfo("hover_changed", PropertyInfo(Variant::OBJECT, "window", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT, "Window"), PropertyInfo(Variant::BOOL, "hovered")));
+
     // 获取系统窗口句柄
     ClassDB::bind_method(D_METHOD("get_window_system_handle", "window"), &HideTaskBarInWindowsSystem::get_window_system_handle);
-    // // 通过Window对象直接操作的方法
-    // ClassDB::bind_method(D_METHOD("hide_window_by_object", "window"), &HideTaskBarInWindowsSystem::hide_window_by_object);
-    // ClassDB::bind_method(D_METHOD("show_window_by_object", "window"), &HideTaskBarInWindowsSystem::show_window_by_object);
-    // ClassDB::bind_method(D_METHOD("is_window_visible_by_object", "window"), &HideTaskBarInWindowsSystem::is_window_visible_by_object);
+
+    // 窗口句柄缓存
+    ClassDB::bind_method(D_METHOD("get_handle_cache_stats"), &HideTaskBarInWindowsSystem::get_handle_cache_stats);
+    ClassDB::bind_method(D_METHOD("clear_handle_cache"), &HideTaskBarInWindowsSystem::clear_handle_cache);
+
+    // 扩展样式影子状态同步
+    ClassDB::bind_method(D_METHOD("resync_window_styles", "window"), &HideTaskBarInWindowsSystem::resync_window_styles);
+    ClassDB::bind_method(D_METHOD("resync_all_window_styles"), &HideTaskBarInWindowsSystem::resync_all_window_styles);
+
+    // 批量操作与队列模式
+    ClassDB::bind_method(D_METHOD("hide_many", "windows"), &HideTaskBarInWindowsSystem::hide_many);
+    ClassDB::bind_method(D_METHOD("show_many", "windows"), &HideTaskBarInWindowsSystem::show_many);
+    ClassDB::bind_method(D_METHOD("set_clickable_many", "windows", "clickable"), &HideTaskBarInWindowsSystem::set_clickable_many);
+    ClassDB::bind_method(D_METHOD("set_queued_mode", "enabled"), &HideTaskBarInWindowsSystem::set_queued_mode);
+    ClassDB::bind_method(D_METHOD("is_queued_mode"), &HideTaskBarInWindowsSystem::is_queued_mode);
+    ClassDB::bind_method(D_METHOD("commit"), &HideTaskBarInWindowsSystem::commit);
+
+    // 异步模式
+    ClassDB::bind_method(D_METHOD("set_async_mode", "enabled"), &HideTaskBarInWindowsSystem::set_async_mode);
+    ClassDB::bind_method(D_METHOD("is_async_mode"), &HideTaskBarInWindowsSystem::is_async_mode);
+    ClassDB::bind_method(D_METHOD("hide_async", "window"), &HideTaskBarInWindowsSystem::hide_async);
+    ClassDB::bind_method(D_METHOD("show_async", "window"), &HideTaskBarInWindowsSystem::show_async);
+    ClassDB::bind_method(D_METHOD("set_clickable_async", "window", "clickable"), &HideTaskBarInWindowsSystem::set_clickable_async);
+    ClassDB::bind_method(D_METHOD("poll_async_results"), &HideTaskBarInWindowsSystem::poll_async_results);
+    ADD_SIGNAL(MethodInfo("operation_completed", PropertyInfo(Variant::INT, "request_id"), PropertyInfo(Variant::BOOL, "ok")));
+
+    // 自动应用策略
+    ClassDB::bind_method(D_METHOD("add_policy_rule", "match_by", "pattern", "taskbar_visible", "clickable"), &HideTaskBarInWindowsSystem::add_policy_rule);
+    ClassDB::bind_method(D_METHOD("clear_policy_rules"), &HideTaskBarInWindowsSystem::clear_policy_rules);
+    ClassDB::bind_method(D_METHOD("get_policy_rule_count"), &HideTaskBarInWindowsSystem::get_policy_rule_count);
+    ClassDB::bind_method(D_METHOD("set_policy_enabled", "enabled"), &HideTaskBarInWindowsSystem::set_policy_enabled);
+    ClassDB::bind_method(D_METHOD("is_policy_enabled"), &HideTaskBarInWindowsSystem::is_policy_enabled);
+
+    // 样式配置
+    ClassDB::bind_method(D_METHOD("save_style_profile"), &HideTaskBarInWindowsSystem::save_style_profile);
+    ClassDB::bind_method(D_METHOD("load_style_profile", "data"), &HideTaskBarInWindowsSystem::load_style_profile);
+    ClassDB::bind_method(D_METHOD("clear_style_profile"), &HideTaskBarInWindowsSystem::clear_style_profile);
+    ClassDB::bind_method(D_METHOD("get_style_profile_size"), &HideTaskBarInWindowsSystem::get_style_profile_size);
+
+    // 窗口池
+    ClassDB::bind_method(D_METHOD("configure_window_pool", "low_watermark", "grow_by", "click_through"), &HideTaskBarInWindowsSystem::configure_window_pool, DEFVAL(true));
+    ClassDB::bind_method(D_METHOD("fill_window_pool", "count"), &HideTaskBarInWindowsSystem::fill_window_pool);
+    ClassDB::bind_method(D_METHOD("acquire_pooled_window"), &HideTaskBarInWindowsSystem::acquire_pooled_window);
+    ClassDB::bind_method(D_METHOD("release_pooled_window", "window"), &HideTaskBarInWindowsSystem::release_pooled_window);
+    ClassDB::bind_method(D_METHOD("clear_window_pool"), &HideTaskBarInWindowsSystem::clear_window_pool);
+    ClassDB::bind_method(D_METHOD("get_window_pool_stats"), &HideTaskBarInWindowsSystem::get_window_pool_stats);
+
+    // 运行统计
+    ClassDB::bind_method(D_METHOD("get_stats"), &HideTaskBarInWindowsSystem::get_stats);
+    ClassDB::bind_method(D_METHOD("reset_stats"), &HideTaskBarInWindowsSystem::reset_stats);
+
+    // 诊断事件
+    ClassDB::bind_method(D_METHOD("set_trace_level", "level"), &HideTaskBarInWindowsSystem::set_trace_level);
+    ClassDB::bind_method(D_METHOD("get_trace_level"), &HideTaskBarInWindowsSystem::get_trace_level);
+    ClassDB::bind_method(D_METHOD("set_trace_print_level", "level"), &HideTaskBarInWindowsSystem::set_trace_print_level);
+    ClassDB::bind_method(D_METHOD("get_trace_print_level"), &HideTaskBarInWindowsSystem::get_trace_print_level);
+    ClassDB::bind_method(D_METHOD("dump_trace"), &HideTaskBarInWindowsSystem::dump_trace);
+    ClassDB::bind_method(D_METHOD("dump_trace_binary"), &HideTaskBarInWindowsSystem::dump_trace_binary);
+    ClassDB::bind_method(D_METHOD("clear_trace"), &HideTaskBarInWindowsSystem::clear_trace);
+
+    // 平台后端
+    ClassDB::bind_method(D_METHOD("set_backend", "name"), &HideTaskBarInWindowsSystem::set_backend);
+    ClassDB::bind_method(D_METHOD("get_backend_name"), &HideTaskBarInWindowsSystem::get_backend_name);
 }
 
 HideTaskBarInWindowsSystem::HideTaskBarInWindowsSystem() {
-    UtilityFunctions::print("HideTaskBarInWindowsSystem instance created");
+    set_backend("default");
+    HIDE_TASKBAR_TRACE(TRACE_LEVEL_INFO, TRACE_OP_LIFECYCLE, TRACE_NO_WINDOW, true, "HideTaskBarInWindowsSystem instance created");
 }
 
 HideTaskBarInWindowsSystem::~HideTaskBarInWindowsSystem() {
-    UtilityFunctions::print("HideTaskBarInWindowsSystem instance destroyed");
+    clear_window_pool();
+    stop_hover();
+    stop_fades();
+    set_style_watch_enabled(false);
+    set_async_mode(false);
+    clear_style_profile();
+    set_policy_enabled(false);
+    unregister_all_windows();
+    if (flush_scheduled) {
+        RenderingServer::get_singleton()->disconnect("frame_pre_draw", flush_callable);
+    }
+    unwatch_all_windows();
+    HIDE_TASKBAR_TRACE(TRACE_LEVEL_INFO, TRACE_OP_LIFECYCLE, TRACE_NO_WINDOW, true, "HideTaskBarInWindowsSystem instance destroyed");
 }
 
-#ifdef _WIN32
-HWND HideTaskBarInWindowsSystem::get_window_handle(Window* window) {
-    if (!window) {
-        UtilityFunctions::print("Window object is null");
-        return NULL;
-    }
-    
-    // 获取窗口ID
-    uint32_t window_id = window->get_window_id();
-    UtilityFunctions::print("Window ID: ", window_id);
-    
-    // 通过DisplayServer获取窗口句柄
-    int64_t handle = DisplayServer::get_singleton()->window_get_native_handle(
-        DisplayServer::HandleType::WINDOW_HANDLE, window_id);
-    HWND hwnd = (HWND)handle;
-    
-    if (hwnd) {
-        UtilityFunctions::print("Got window handle: ", (uint64_t)hwnd);
-    } else {
-        UtilityFunctions::print("Failed to get valid window handle");
+// 运行统计
+Dictionary HideTaskBarInWindowsSystem::get_stats() const {
+    Dictionary calls;
+    for (int op = 0; op < TRACE_OP_COUNT; op++) {
+        calls[trace_op_name((TraceOp)op)] = stats_get_calls(op);
+    }
+
+    const LatencyHistogram& latency = stats_get_native_latency();
+    Dictionary stats;
+    stats["calls"] = calls;
+    stats["cache_hits"] = stats_get_cache_hits();
+    stats["cache_misses"] = stats_get_cache_misses();
+    stats["redundant"] = stats_get_redundant();
+    stats["native_changes"] = latency.get_count();
+    stats["native_windows"] = stats_get_native_windows();
+    stats["native_p50_us"] = latency.get_percentile(0.5) / 1000.0;
+    stats["native_p99_us"] = latency.get_percentile(0.99) / 1000.0;
+    stats["native_max_us"] = latency.get_max() / 1000.0;
+    return stats;
+}
+
+void HideTaskBarInWindowsSystem::reset_stats() {
+    stats_reset();
+}
+
+// 诊断事件
+// 级别与环形缓冲区是进程级的，所有实例共用（执行线程与启动阶段的事件也在其中）
+void HideTaskBarInWindowsSystem::set_trace_level(int level) {
+    trace_set_level(level);
+}
+
+int HideTaskBarInWindowsSystem::get_trace_level() const {
+    return trace_get_level();
+}
+
+void HideTaskBarInWindowsSystem::set_trace_print_level(int level) {
+    trace_set_print_level(level);
+}
+
+int HideTaskBarInWindowsSystem::get_trace_print_level() const {
+    return trace_get_print_level();
+}
+
+String HideTaskBarInWindowsSystem::dump_trace() const {
+    std::vector<TraceEvent> events;
+    uint64_t dropped = trace_snapshot(events);
+
+    std::string text;
+    if (dropped > 0) {
+        text += std::to_string(dropped) + " earlier events dropped\n";
+    }
+    for (const TraceEvent& event : events) {
+        text += trace_format_event(event);
+        text += "\n";
     }
-    
-    return hwnd;
+    return String::utf8(text.c_str());
+}
+
+PackedByteArray HideTaskBarInWindowsSystem::dump_trace_binary() const {
+    std::vector<TraceEvent> events;
+    uint64_t dropped = trace_snapshot(events);
+    std::vector<uint8_t> bytes;
+    trace_serialize(events, dropped, bytes);
+
+    PackedByteArray result;
+    result.resize((int64_t)bytes.size());
+    memcpy(result.ptrw(), bytes.data(), bytes.size());
+    return result;
+}
+
+void HideTaskBarInWindowsSystem::clear_trace() {
+    trace_clear();
 }
 
-HWND HideTaskBarInWindowsSystem::get_main_window_handle() {
-    // 直接通过DisplayServer获取主窗口(索引为0)的Windows句柄
-    int64_t handle = DisplayServer::get_singleton()->window_get_native_handle(
-        DisplayServer::HandleType::WINDOW_HANDLE, 0);
-    HWND hwnd = (HWND)handle;
-    
-    if (hwnd && IsWindow(hwnd)) {
-        UtilityFunctions::print("Got main window handle via DisplayServer: ", (uint64_t)hwnd);
-        return hwnd;
+// 平台后端
+bool HideTaskBarInWindowsSystem::set_backend(const String& name) {
+    std::string backend_name = name.utf8().get_data();
+    std::unique_ptr<WindowBackend> backend;
+    WindowHandleLookup lookup = display_server_lookup;
+    void* lookup_userdata = nullptr;
+
+    if (backend_name == "fake") {
+        // 伪后端自己模拟句柄查找，窗口第一次出现时自动创建
+        FakeWindowBackend* fake = new FakeWindowBackend();
+        fake->set_auto_create(true);
+        lookup = FakeWindowBackend::lookup_handle;
+        lookup_userdata = fake;
+        backend.reset(fake);
     } else {
-        UtilityFunctions::print("Failed to get main window handle via DisplayServer");
-    }
-    
-    // 如果通过DisplayServer无法获取，则尝试备用方法
-    // 枚举所有顶级窗口并查找属于当前进程的窗口
-    DWORD current_process_id = GetCurrentProcessId();
-    HWND found_hwnd = NULL;
-    
-    EnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL {
-        // 获取窗口所属的进程ID
-        DWORD window_process_id;
-        GetWindowThreadProcessId(hwnd, &window_process_id);
-        
-        // 检查是否属于当前进程
-        DWORD current_pid = *((DWORD*)lParam);
-        if (window_process_id == current_pid) {
-            // 检查是否为可见的顶层窗口
-            if (IsWindowVisible(hwnd) && GetParent(hwnd) == NULL) {
-                // 检查窗口样式，寻找主窗口特征
-                LONG style = GetWindowLong(hwnd, GWL_STYLE);
-                if ((style & WS_CAPTION) && (style & WS_SYSMENU)) {
-                    // 找到可能的主窗口，保存句柄并停止枚举
-                    *((HWND*)lParam) = hwnd;
-                    return FALSE; // 停止枚举
-                }
-            }
+        backend = create_window_backend(backend_name);
+
+        // X11后端只能处理X11 DisplayServer返回的句柄（Wayland下句柄不是X11窗口）
+        DisplayServer* display_server = DisplayServer::get_singleton();
+        if (backend && std::string(backend->get_name()) == "x11" && display_server && display_server->get_name() != "X11") {
+            backend = create_null_window_backend();
         }
-        return TRUE; // 继续枚举
-    }, (LPARAM)&found_hwnd);
-    
-    if (found_hwnd && IsWindow(found_hwnd)) {
-        UtilityFunctions::print("Got main window handle via enumeration: ", (uint64_t)found_hwnd);
-        return found_hwnd;
     }
-    
-    UtilityFunctions::print("Failed to find main window handle");
-    return NULL;
+
+    if (!backend) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_BACKEND, TRACE_NO_WINDOW, false, "Unknown window backend");
+        return false;
+    }
+
+    // 执行线程先处理完旧后端上的命令；悬停窗口属于旧后端的句柄，一并停止
+    executor.stop();
+    stop_hover();
+    stop_fades();
+
+    // 旧后端的句柄与影子状态全部作废
+    unwatch_all_windows();
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        manager.set_backend(std::move(backend));
+        manager.set_handle_lookup(lookup, lookup_userdata);
+    }
+    // 旧后端销毁时已卸载自己的钩子
+    show_hooked = false;
+    update_show_hook();
+    if (async_mode) {
+        executor.start();
+    }
+    // 后端名称是字符串常量，可以直接作为事件消息
+    HIDE_TASKBAR_TRACE(TRACE_LEVEL_INFO, TRACE_OP_BACKEND, TRACE_NO_WINDOW, true, manager.get_backend()->get_name());
+    return true;
 }
 
-bool HideTaskBarInWindowsSystem::hide(Window* window) {
-    HWND hwnd = get_window_handle(window);
-    
-    if (hwnd && IsWindow(hwnd)) {
-        // 修改窗口扩展样式以隐藏任务栏图标
-        LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        if (exStyle != 0) {
-            exStyle &= ~WS_EX_APPWINDOW;  // 移除APPWINDOW标志
-            exStyle |= WS_EX_TOOLWINDOW;   // 添加TOOLWINDOW标志
-            SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
-            
-            // 重新设置窗口以应用更改
-            ShowWindow(hwnd, SW_HIDE);
-            ShowWindow(hwnd, SW_SHOW);
-            
-            UtilityFunctions::print("Successfully hidden window from taskbar");
-            return true;
+String HideTaskBarInWindowsSystem::get_backend_name() const {
+    return String(manager.get_backend()->get_name());
+}
+
+// 窗口句柄缓存
+// 以窗口ID为键缓存原生句柄，命中时不再访问DisplayServer。
+// Window关闭、隐藏（子窗口会重建原生窗口）或离开场景树时缓存失效。
+WindowRecord* HideTaskBarInWindowsSystem::get_window_record(Window* window) {
+    if (!window) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_RESOLVE, TRACE_NO_WINDOW, false, "Window object is null");
+        return nullptr;
+    }
+
+    int32_t window_id = window->get_window_id();
+    if (window_id < 0) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_RESOLVE, TRACE_NO_WINDOW, false, "Window has no native window");
+        return nullptr;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    bool inserted = false;
+    WindowRecord* record = manager.resolve((uint32_t)window_id, window->get_instance_id(), &inserted);
+    if (!record) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_RESOLVE, (uint32_t)window_id, false, "Failed to get valid window handle");
+        return nullptr;
+    }
+
+    if (inserted) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_DEBUG, TRACE_OP_RESOLVE, (uint32_t)window_id, true, "Got window handle");
+    }
+    // 异步执行器解析的记录没有监听信号，第一次在主线程访问时补上
+    if (!record->watched) {
+        watch_window(window, (uint32_t)window_id);
+        record->watched = true;
+    }
+    return record;
+}
+
+void HideTaskBarInWindowsSystem::watch_window(Window* window, uint32_t window_id) {
+    uint64_t object_id = window->get_instance_id();
+    if (style_watch_enabled) {
+        watch_record_styles(window_id, object_id, true);
+    }
+
+    auto it = watched_windows.find(object_id);
+    if (it != watched_windows.end()) {
+        // 已经连接过信号，只更新当前窗口ID
+        it->second.window_id = window_id;
+        return;
+    }
+
+    WatchedWindow watched;
+    watched.window_id = window_id;
+    watched.on_invalidated = callable_mp(this, &HideTaskBarInWindowsSystem::_on_window_invalidated).bind(object_id);
+    watched.on_tree_exiting = callable_mp(this, &HideTaskBarInWindowsSystem::_on_window_tree_exiting).bind(object_id);
+
+    // 子窗口隐藏后再显示会重建原生窗口，因此可见性变化也视为失效
+    window->connect("visibility_changed", watched.on_invalidated);
+    window->connect("close_requested", watched.on_invalidated);
+    window->connect("tree_exiting", watched.on_tree_exiting);
+    watched_windows[object_id] = watched;
+}
+
+void HideTaskBarInWindowsSystem::unwatch_all_windows() {
+    // 不再监听失效信号的窗口不能继续跟踪（对象ID可能失效），跟踪线程与渐变线程必须在加锁前停止
+    stop_hover();
+    stop_fades();
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    // 断开所有失效信号，避免Window在本对象销毁后回调
+    for (const auto& pair : watched_windows) {
+        if (style_watch_enabled) {
+            watch_record_styles(pair.second.window_id, pair.first, false);
+        }
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(pair.first)));
+        if (window) {
+            window->disconnect("visibility_changed", pair.second.on_invalidated);
+            window->disconnect("close_requested", pair.second.on_invalidated);
+            window->disconnect("tree_exiting", pair.second.on_tree_exiting);
         }
     }
-    
-    UtilityFunctions::print("Failed to hide window from taskbar");
-    return false;
+    watched_windows.clear();
+    click_masks.clear();
+    style_changes.clear();
+    manager.clear();
 }
 
-bool HideTaskBarInWindowsSystem::show(Window* window) {
-    HWND hwnd = get_window_handle(window);
-    
-    if (hwnd && IsWindow(hwnd)) {
-        // 恢复窗口扩展样式以显示任务栏图标
-        LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        if (exStyle != 0) {
-            exStyle |= WS_EX_APPWINDOW;    // 添加APPWINDOW标志
-            exStyle &= ~WS_EX_TOOLWINDOW;  // 移除TOOLWINDOW标志
-            SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
-            
-            // 重新设置窗口以应用更改
-            ShowWindow(hwnd, SW_HIDE);
-            ShowWindow(hwnd, SW_SHOW);
-            
-            UtilityFunctions::print("Successfully shown window on taskbar");
-            return true;
+void HideTaskBarInWindowsSystem::_on_window_invalidated(uint64_t object_id) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    // 原生窗口可能被重建，输入区域与悬停状态需要重新提交
+    click_masks.erase(object_id);
+    hover_tracker.invalidate(object_id);
+
+    auto it = watched_windows.find(object_id);
+    if (it != watched_windows.end()) {
+        if (style_watch_enabled) {
+            watch_record_styles(it->second.window_id, object_id, false);
         }
+        manager.invalidate(it->second.window_id, object_id);
     }
-    
-    UtilityFunctions::print("Failed to show window on taskbar");
-    return false;
 }
 
-bool HideTaskBarInWindowsSystem::is_visible(Window* window) {
-    HWND hwnd = get_window_handle(window);
-    
-    if (hwnd && IsWindow(hwnd)) {
-        // 检查窗口扩展样式
-        LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        bool hasAppWindow = (exStyle & WS_EX_APPWINDOW) != 0;
-        bool hasToolWindow = (exStyle & WS_EX_TOOLWINDOW) != 0;
-        
-        // 判断是否在任务栏显示
-        bool inTaskbar = hasAppWindow && !hasToolWindow;
-        
-        UtilityFunctions::print("Window visibility on taskbar: ", inTaskbar ? "Yes" : "No");
-        return inTaskbar;
-    }
-    
-    UtilityFunctions::print("Unable to determine window visibility on taskbar");
-    return false;
+void HideTaskBarInWindowsSystem::_on_window_tree_exiting(uint64_t object_id) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    click_masks.erase(object_id);
+    hover_tracker.remove_window(object_id);
+    fader.cancel(object_id);
+
+    auto it = watched_windows.find(object_id);
+    if (it == watched_windows.end()) {
+        return;
+    }
+
+    if (style_watch_enabled) {
+        watch_record_styles(it->second.window_id, object_id, false);
+    }
+    manager.invalidate(it->second.window_id, object_id);
+
+    Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(object_id)));
+    if (window) {
+        window->disconnect("visibility_changed", it->second.on_invalidated);
+        window->disconnect("close_requested", it->second.on_invalidated);
+        window->disconnect("tree_exiting", it->second.on_tree_exiting);
+    }
+    watched_windows.erase(it);
 }
 
-// 主窗口相关方法
-bool HideTaskBarInWindowsSystem::hide_main_window() {
-    HWND hwnd = get_main_window_handle();
-    
-    if (hwnd && IsWindow(hwnd)) {
-        // 修改窗口扩展样式以隐藏任务栏图标
-        LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        if (exStyle != 0) {
-            exStyle &= ~WS_EX_APPWINDOW;  // 移除APPWINDOW标志
-            exStyle |= WS_EX_TOOLWINDOW;   // 添加TOOLWINDOW标志
-            SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
-            
-            // 重新设置窗口以应用更改
-            ShowWindow(hwnd, SW_HIDE);
-            ShowWindow(hwnd, SW_SHOW);
-            
-            UtilityFunctions::print("Successfully hidden main window from taskbar");
-            return true;
+Dictionary HideTaskBarInWindowsSystem::get_handle_cache_stats() const {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    Dictionary stats;
+    stats["hits"] = manager.get_cache_hits();
+    stats["misses"] = manager.get_cache_misses();
+    stats["size"] = (int64_t)manager.get_cache_size();
+    return stats;
+}
+
+void HideTaskBarInWindowsSystem::clear_handle_cache() {
+    unwatch_all_windows();
+}
+
+// 扩展样式影子状态
+// 只记录本扩展管理的样式位。重复请求目标状态时直接返回，查询也直接读取影子状态。
+// 其他程序修改样式后可调用resync_window_styles重新同步。
+bool HideTaskBarInWindowsSystem::resync_window_styles(Window* window) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_window_record(window);
+    return record && manager.resync(*record);
+}
+
+void HideTaskBarInWindowsSystem::resync_all_window_styles() {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    manager.resync_all();
+}
+
+// 批量操作与队列模式
+// 同一窗口的多次请求先合并，再一次性提交给后端。
+// 队列模式下的变更在本帧绘制前（RenderingServer的frame_pre_draw信号）统一提交。
+bool HideTaskBarInWindowsSystem::submit_change(Window* window, const WindowStyleRequest& request) {
+    return submit_record(get_window_record(window), request);
+}
+
+bool HideTaskBarInWindowsSystem::submit_record(WindowRecord* record, const WindowStyleRequest& request) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    if (!record) {
+        return false;
+    }
+
+    if (queued_mode) {
+        manager.queue(*record, request);
+        schedule_flush();
+        return true;
+    }
+    return manager.apply(&record, &request, 1) == 1;
+}
+
+int HideTaskBarInWindowsSystem::apply_many(const Array& windows, const WindowStyleRequest& request) {
+    if (async_mode) {
+        return submit_many_async(windows, request);
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowStyleBatch batch;
+    int queued = 0;
+    for (int64_t i = 0; i < windows.size(); i++) {
+        Window* window = Object::cast_to<Window>(windows[i]);
+        WindowRecord* record = get_window_record(window);
+        if (!record) {
+            continue;
+        }
+        if (request.set_clickable) {
+            click_masks.erase(window->get_instance_id());
+        }
+
+        if (queued_mode) {
+            manager.queue(*record, request);
+            queued++;
+        } else {
+            batch.add(record, request);
         }
     }
-    
-    UtilityFunctions::print("Failed to hide main window from taskbar");
-    return false;
+
+    if (queued_mode) {
+        if (queued > 0) {
+            schedule_flush();
+        }
+        return queued;
+    }
+    return manager.apply(batch);
 }
 
-bool HideTaskBarInWindowsSystem::show_main_window() {
-    HWND hwnd = get_main_window_handle();
-    
-    if (hwnd && IsWindow(hwnd)) {
-        // 恢复窗口扩展样式以显示任务栏图标
-        LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        if (exStyle != 0) {
-            exStyle |= WS_EX_APPWINDOW;    // 添加APPWINDOW标志
-            exStyle &= ~WS_EX_TOOLWINDOW;  // 移除TOOLWINDOW标志
-            SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
-            
-            // 重新设置窗口以应用更改
-            ShowWindow(hwnd, SW_HIDE);
-            ShowWindow(hwnd, SW_SHOW);
-            
-            UtilityFunctions::print("Successfully shown main window on taskbar");
-            return true;
+int HideTaskBarInWindowsSystem::hide_many(const Array& windows) {
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = false;
+    return apply_many(windows, request);
+}
+
+int HideTaskBarInWindowsSystem::show_many(const Array& windows) {
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = true;
+    return apply_many(windows, request);
+}
+
+int HideTaskBarInWindowsSystem::set_clickable_many(const Array& windows, bool clickable) {
+    WindowStyleRequest request;
+    request.set_clickable = true;
+    request.clickable = clickable;
+    return apply_many(windows, request);
+}
+
+void HideTaskBarInWindowsSystem::set_queued_mode(bool enabled) {
+    queued_mode = enabled;
+    if (!enabled) {
+        // 退出队列模式时立即提交剩余变更
+        commit();
+    }
+}
+
+bool HideTaskBarInWindowsSystem::is_queued_mode() const {
+    return queued_mode;
+}
+
+int HideTaskBarInWindowsSystem::commit() {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    return manager.commit();
+}
+
+void HideTaskBarInWindowsSystem::schedule_flush() {
+    if (flush_scheduled) {
+        return;
+    }
+
+    RenderingServer* rendering_server = RenderingServer::get_singleton();
+    if (!rendering_server) {
+        return; // 没有渲染服务器时只能显式调用commit
+    }
+
+    if (!flush_callable.is_valid()) {
+        flush_callable = callable_mp(this, &HideTaskBarInWindowsSystem::_on_frame_pre_draw);
+    }
+    rendering_server->connect("frame_pre_draw", flush_callable, CONNECT_ONE_SHOT);
+    flush_scheduled = true;
+}
+
+void HideTaskBarInWindowsSystem::_on_frame_pre_draw() {
+    flush_scheduled = false;
+    commit();
+}
+
+// 异步模式
+// 调用线程只读取窗口ID与对象ID后放入无锁队列，句柄解析、样式计算与系统调用都在执行线程完成。
+// Win32下执行线程在窗口线程之外调用：隐藏/显示通过SWP_ASYNCWINDOWPOS投递到窗口线程，
+// 样式写入由窗口线程在正常的消息循环中处理，游戏循环不会等待外壳或合成器。
+void HideTaskBarInWindowsSystem::set_async_mode(bool enabled) {
+    if (enabled == async_mode) {
+        return;
+    }
+
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (!async_poll_callable.is_valid()) {
+        async_poll_callable = callable_mp(this, &HideTaskBarInWindowsSystem::_on_async_process_frame);
+    }
+
+    if (enabled) {
+        // 队列模式中尚未提交的变更先同步提交，保持先后顺序
+        commit();
+        async_mode = true;
+        executor.start();
+        if (tree) {
+            tree->connect("process_frame", async_poll_callable);
         }
+        return;
     }
-    
-    UtilityFunctions::print("Failed to show main window on taskbar");
-    return false;
+
+    async_mode = false;
+    executor.stop();
+    if (tree && tree->is_connected("process_frame", async_poll_callable)) {
+        tree->disconnect("process_frame", async_poll_callable);
+    }
+    poll_async_results();
 }
 
-bool HideTaskBarInWindowsSystem::is_main_window_visible() {
-    HWND hwnd = get_main_window_handle();
-    
-    if (hwnd && IsWindow(hwnd)) {
-        // 检查窗口扩展样式
-        LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        bool hasAppWindow = (exStyle & WS_EX_APPWINDOW) != 0;
-        bool hasToolWindow = (exStyle & WS_EX_TOOLWINDOW) != 0;
-        
-        // 判断是否在任务栏显示
-        bool inTaskbar = hasAppWindow && !hasToolWindow;
-        
-        UtilityFunctions::print("Main window visibility on taskbar: ", inTaskbar ? "Yes" : "No");
-        return inTaskbar;
-    }
-    
-    UtilityFunctions::print("Unable to determine main window visibility on taskbar");
-    return false;
+bool HideTaskBarInWindowsSystem::is_async_mode() const {
+    return async_mode;
 }
 
-bool HideTaskBarInWindowsSystem::set_clickable(Window* window, bool clickable) {
-#ifdef _WIN32
-    HWND hwnd = get_window_handle(window);
-    
-    if (hwnd && IsWindow(hwnd)) {
-        LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        if (exStyle != 0) {
-            if (clickable) {
-                // 移除穿透样式，使窗口可点击
-                exStyle &= ~WS_EX_LAYERED;
-                exStyle &= ~WS_EX_TRANSPARENT;
-                SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
-                
-                // 恢复窗口的可见性
-                ShowWindow(hwnd, SW_SHOW);
-                
-                UtilityFunctions::print("Window made clickable");
-                return true;
-            } else {
-                // 设置窗口为穿透模式
-                exStyle |= WS_EX_LAYERED | WS_EX_TRANSPARENT;
-                SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
-                
-                // 设置透明度为完全不透明但保持穿透
-                SetLayeredWindowAttributes(hwnd, 0, 255, LWA_ALPHA);
-                
-                UtilityFunctions::print("Window made click-through");
-                return true;
+uint64_t HideTaskBarInWindowsSystem::submit_async(Window* window, const WindowStyleRequest& request) {
+    if (!async_mode) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_ASYNC, TRACE_NO_WINDOW, false, "Async mode is not enabled");
+        return 0;
+    }
+    if (!window) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_ASYNC, TRACE_NO_WINDOW, false, "Window object is null");
+        return 0;
+    }
+
+    int32_t window_id = window->get_window_id();
+    if (window_id < 0) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_ASYNC, TRACE_NO_WINDOW, false, "Window has no native window");
+        return 0;
+    }
+    return executor.submit((uint32_t)window_id, window->get_instance_id(), request);
+}
+
+uint64_t HideTaskBarInWindowsSystem::submit_main_window_async(const WindowStyleRequest& request) {
+    // 与get_main_window_record一致：有场景树时以根Window为所属对象
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    Window* root = tree ? tree->get_root() : nullptr;
+    if (root) {
+        return submit_async(root, request);
+    }
+    return executor.submit(WindowStyleManager::MAIN_WINDOW_ID, 0, request);
+}
+
+int HideTaskBarInWindowsSystem::submit_many_async(const Array& windows, const WindowStyleRequest& request) {
+    // 同一批提交的命令在执行线程上通常会合并为一次后端调用
+    int submitted = 0;
+    for (int64_t i = 0; i < windows.size(); i++) {
+        if (submit_async(Object::cast_to<Window>(windows[i]), request) != 0) {
+            submitted++;
+        }
+    }
+    return submitted;
+}
+
+int64_t HideTaskBarInWindowsSystem::hide_async(Window* window) {
+    stats_record_call(TRACE_OP_ASYNC);
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = false;
+    return (int64_t)submit_async(window, request);
+}
+
+int64_t HideTaskBarInWindowsSystem::show_async(Window* window) {
+    stats_record_call(TRACE_OP_ASYNC);
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = true;
+    return (int64_t)submit_async(window, request);
+}
+
+int64_t HideTaskBarInWindowsSystem::set_clickable_async(Window* window, bool clickable) {
+    stats_record_call(TRACE_OP_ASYNC);
+    WindowStyleRequest request;
+    request.set_clickable = true;
+    request.clickable = clickable;
+    return (int64_t)submit_async(window, request);
+}
+
+int HideTaskBarInWindowsSystem::poll_async_results() {
+    int count = 0;
+    WindowCommandResult result;
+    while (executor.poll_result(result)) {
+        count++;
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(result.owner_id)));
+        if (window && result.ok) {
+            if (result.request.set_clickable) {
+                click_masks.erase(result.owner_id);
+            }
+            // 执行线程解析的记录在主线程补上失效信号
+            std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+            WindowRecord* record = manager.find(result.window_id, result.owner_id);
+            if (record && !record->watched) {
+                watch_window(window, result.window_id);
+                record->watched = true;
             }
         }
+        emit_signal("operation_completed", (int64_t)result.request_id, result.ok);
     }
-    
-    UtilityFunctions::print("Failed to set window click-through property");
-    return false;
-#else
-    UtilityFunctions::print("Current platform does not support click-through functionality");
-    return false;
-#endif
+    return count;
 }
 
-bool HideTaskBarInWindowsSystem::is_clickable(Window* window) {
-#ifdef _WIN32
-    HWND hwnd = get_window_handle(window);
-    
-    if (hwnd && IsWindow(hwnd)) {
-        LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        
-        // 检查是否设置了穿透样式
-        bool isTransparent = (exStyle & WS_EX_TRANSPARENT) != 0;
-        bool isLayered = (exStyle & WS_EX_LAYERED) != 0;
-        
-        bool clickable = !(isTransparent && isLayered);
-        
-        UtilityFunctions::print("Window clickability: ", clickable ? "Clickable" : "Click-through");
-        return clickable;
-    }
-    
-    UtilityFunctions::print("Unable to determine window clickability");
-    return true; // 默认认为是可点击的
-#else
-    UtilityFunctions::print("Current platform does not support checking click-through status");
-    return true;
-#endif
+void HideTaskBarInWindowsSystem::_on_async_process_frame() {
+    poll_async_results();
 }
 
-int64_t HideTaskBarInWindowsSystem::get_window_system_handle(Window* window) {
-#ifdef _WIN32
-    HWND hwnd = get_window_handle(window);
-    
-    if (hwnd) {
-        UtilityFunctions::print("Retrieved system handle: ", (uint64_t)hwnd);
-        return (int64_t)hwnd;
+// 批量状态查询
+// 句柄与状态直接写入打包数组，脚本每个窗口不需要分别调用is_visible/is_clickable跨越绑定层。
+Dictionary HideTaskBarInWindowsSystem::query_window_states(const Array& windows) {
+    TraceScope trace(TRACE_OP_QUERY);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+
+    // Array按引用共享，默认列表放进新数组，不能改动参数（包括绑定的默认值）
+    Array targets;
+    if (!windows.is_empty()) {
+        targets = windows;
     } else {
-        UtilityFunctions::print("Failed to retrieve system handle");
-        return 0; // 返回0表示无效句柄
-    }
-#else
-    UtilityFunctions::print("Current platform does not support retrieving system handle");
-    return 0;
-#endif
-}
-
-// // 通过Window对象直接操作的方法
-// bool HideTaskBarInWindowsSystem::hide_window_by_object(Window* window) {
-//     if (!window) {
-//         UtilityFunctions::print("Window object is null");
-//         return false;
-//     }
-    
-//     // 通过DisplayServer直接获取窗口句柄
-//     uint32_t window_id = window->get_window_id();
-//     int64_t handle = DisplayServer::get_singleton()->window_get_native_handle(
-//         DisplayServer::HandleType::WINDOW_HANDLE, window_id);
-//     HWND hwnd = (HWND)handle;
-    
-//     if (hwnd && IsWindow(hwnd)) {
-//         LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-//         if (exStyle != 0) {
-//             exStyle &= ~WS_EX_APPWINDOW;
-//             exStyle |= WS_EX_TOOLWINDOW;
-//             SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
-            
-//             ShowWindow(hwnd, SW_HIDE);
-//             ShowWindow(hwnd, SW_SHOW);
-            
-//             UtilityFunctions::print("Successfully hidden window (ID: ", window_id, ") from taskbar");
-//             return true;
-//         }
-//     }
-    
-//     UtilityFunctions::print("Failed to hide window (ID: ", window_id, ") from taskbar");
-//     return false;
-// }
-
-// bool HideTaskBarInWindowsSystem::show_window_by_object(Window* window) {
-//     if (!window) {
-//         UtilityFunctions::print("Window object is null");
-//         return false;
-//     }
-    
-//     // 通过DisplayServer直接获取窗口句柄
-//     uint32_t window_id = window->get_window_id();
-//     int64_t handle = DisplayServer::get_singleton()->window_get_native_handle(
-//         DisplayServer::HandleType::WINDOW_HANDLE, window_id);
-//     HWND hwnd = (HWND)handle;
-    
-//     if (hwnd && IsWindow(hwnd)) {
-//         LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-//         if (exStyle != 0) {
-//             exStyle |= WS_EX_APPWINDOW;
-//             exStyle &= ~WS_EX_TOOLWINDOW;
-//             SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
-            
-//             ShowWindow(hwnd, SW_HIDE);
-//             ShowWindow(hwnd, SW_SHOW);
-            
-//             UtilityFunctions::print("Successfully shown window (ID: ", window_id, ") on taskbar");
-//             return true;
-//         }
-//     }
-    
-//     UtilityFunctions::print("Failed to show window (ID: ", window_id, ") on taskbar");
-//     return false;
-// }
-
-// bool HideTaskBarInWindowsSystem::is_window_visible_by_object(Window* window) {
-//     if (!window) {
-//         UtilityFunctions::print("Window object is null");
-//         return false;
-//     }
-    
-//     // 通过DisplayServer直接获取窗口句柄
-//     uint32_t window_id = window->get_window_id();
-//     int64_t handle = DisplayServer::get_singleton()->window_get_native_handle(
-//         DisplayServer::HandleType::WINDOW_HANDLE, window_id);
-//     HWND hwnd = (HWND)handle;
-    
-//     if (hwnd && IsWindow(hwnd)) {
-//         LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-//         bool hasAppWindow = (exStyle & WS_EX_APPWINDOW) != 0;
-//         bool hasToolWindow = (exStyle & WS_EX_TOOLWINDOW) != 0;
-        
-//         bool inTaskbar = hasAppWindow && !hasToolWindow;
-        
-//         UtilityFunctions::print("Window (ID: ", window_id, ") visibility on taskbar: ", inTaskbar ? "Yes" : "No");
-//         return inTaskbar;
-//     }
-    
-//     UtilityFunctions::print("Unable to determine window (ID: ", window_id, ") visibility on taskbar");
-//     return false;
-// }
-#else
-// 非Windows平台的空实现
-bool HideTaskBarInWindowsSystem::hide(Window* window) {
-    UtilityFunctions::print("Current platform does not support hiding taskbar functionality");
-    return false;
+        for (const auto& pair : watched_windows) {
+            Object* object = ObjectDB::get_instance(ObjectID(pair.first));
+            if (object) {
+                targets.push_back(object);
+            }
+        }
+    }
+
+    int64_t count = targets.size();
+    PackedInt64Array handles;
+    PackedByteArray states;
+    handles.resize(count);
+    states.resize(count);
+    int64_t* handle_data = handles.ptrw();
+    uint8_t* state_data = states.ptrw();
+
+    int valid = 0;
+    for (int64_t i = 0; i < count; i++) {
+        WindowRecord* record = get_window_record(Object::cast_to<Window>(targets[i]));
+        state_data[i] = read_window_state(record);
+        handle_data[i] = state_data[i] ? record->handle : 0;
+        valid += state_data[i] ? 1 : 0;
+    }
+
+    Dictionary result;
+    result["windows"] = targets;
+    result["handles"] = handles;
+    result["states"] = states;
+    trace.finish(valid == count, "Some window states could not be read");
+    return result;
 }
 
-bool HideTaskBarInWindowsSystem::show(Window* window) {
-    UtilityFunctions::print("Current platform does not support showing taskbar functionality");
-    return false;
+// 读取失败时返回0
+uint8_t HideTaskBarInWindowsSystem::read_window_state(WindowRecord* record) {
+    if (!record || !manager.load_style(*record)) {
+        return 0;
+    }
+
+    uint8_t state = STATE_VALID;
+    if (!WindowStyleManager::is_taskbar_visible(record->style)) {
+        state |= STATE_TASKBAR_HIDDEN;
+    }
+    if (!WindowStyleManager::is_clickable(record->style)) {
+        state |= STATE_CLICK_THROUGH;
+    }
+    if (record->style & WINDOW_STYLE_LAYERED) {
+        state |= STATE_LAYERED;
+    }
+    // 不支持不透明度的后端视为不透明
+    if (manager.load_opacity(*record) && record->opacity < 255) {
+        state |= record->opacity == 0 ? STATE_OPACITY_TRANSPARENT : STATE_OPACITY_TRANSLUCENT;
+    }
+    return state;
 }
 
-bool HideTaskBarInWindowsSystem::is_visible(Window* window) {
-    UtilityFunctions::print("Current platform does not support checking taskbar visibility status");
-    return false;
+// 外部样式变化通知
+// 后端报告的窗口只是"可能被修改"（包括本扩展自己的写入），每帧重新读取一次并与影子状态比较；
+// 正在写入（prepare与finish之间）的窗口留到下一帧。点击区域蒙版会改写输入区域，有蒙版的窗口只比较任务栏状态。
+void HideTaskBarInWindowsSystem::set_style_watch_enabled(bool enabled) {
+    if (enabled == style_watch_enabled) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        style_watch_enabled = enabled;
+        for (const auto& pair : watched_windows) {
+            watch_record_styles(pair.second.window_id, pair.first, enabled);
+        }
+        style_changes.clear();
+        style_changes_deferred.clear();
+    }
+
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (!style_watch_callable.is_valid()) {
+        style_watch_callable = callable_mp(this, &HideTaskBarInWindowsSystem::_on_style_watch_process_frame);
+    }
+    if (enabled && tree && !tree->is_connected("process_frame", style_watch_callable)) {
+        tree->connect("process_frame", style_watch_callable);
+    } else if (!enabled && tree && tree->is_connected("process_frame", style_watch_callable)) {
+        tree->disconnect("process_frame", style_watch_callable);
+    }
+    HIDE_TASKBAR_TRACE(TRACE_LEVEL_INFO, TRACE_OP_STYLE_WATCH, TRACE_NO_WINDOW, true, enabled ? "Style watch enabled" : "Style watch disabled");
 }
 
-// 非Windows平台的空实现（新增方法）
-bool HideTaskBarInWindowsSystem::hide_main_window() {
-    UtilityFunctions::print("Current platform does not support hiding main window taskbar functionality");
-    return false;
+bool HideTaskBarInWindowsSystem::is_style_watch_enabled() const {
+    return style_watch_enabled;
 }
 
-bool HideTaskBarInWindowsSystem::show_main_window() {
-    UtilityFunctions::print("Current platform does not support showing main window taskbar functionality");
-    return false;
+void HideTaskBarInWindowsSystem::set_auto_reassert(bool enabled) {
+    auto_reassert = enabled;
 }
 
-bool HideTaskBarInWindowsSystem::is_main_window_visible() {
-    UtilityFunctions::print("Current platform does not support checking main window taskbar visibility status");
-    return false;
+bool HideTaskBarInWindowsSystem::is_auto_reassert() const {
+    return auto_reassert;
 }
 
-bool HideTaskBarInWindowsSystem::hide_window_by_object(Window* window) {
-    UtilityFunctions::print("Current platform does not support hiding window taskbar functionality");
-    return false;
+void HideTaskBarInWindowsSystem::watch_record_styles(uint32_t window_id, uint64_t object_id, bool enabled) {
+    WindowRecord* record = manager.find(window_id, object_id);
+    if (record && !manager.get_backend()->watch_style_changes(record->handle, enabled) && enabled) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_STYLE_WATCH, window_id, false, "Backend cannot watch style changes");
+    }
 }
 
-bool HideTaskBarInWindowsSystem::show_window_by_object(Window* window) {
-    UtilityFunctions::print("Current platform does not support showing window taskbar functionality");
-    return false;
+int HideTaskBarInWindowsSystem::poll_style_changes() {
+    struct StyleChange {
+        uint64_t owner_id = 0;
+        bool taskbar_visible = false;
+        bool clickable = true;
+    };
+    std::vector<StyleChange> changes;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        manager.get_backend()->poll_style_changes(style_changes);
+        style_changes_deferred.clear();
+        for (NativeWindowHandle handle : style_changes) {
+            WindowRecord* record = manager.find_by_handle(handle);
+            if (!record) {
+                continue;
+            }
+            if (record->in_flight > 0) {
+                style_changes_deferred.push_back(handle);
+                continue;
+            }
+            if (!record->style_known) {
+                // 没有可比较的状态，只记下当前值
+                manager.load_style(*record);
+                continue;
+            }
+
+            uint32_t expected = record->style;
+            if (!manager.resync(*record)) {
+                continue;
+            }
+            uint32_t mask = WINDOW_STYLE_TASKBAR_MASK;
+            if (click_masks.find(record->owner_id) == click_masks.end()) {
+                mask |= WINDOW_STYLE_CLICK_THROUGH_MASK;
+            }
+            if (((expected ^ record->style) & mask) == 0) {
+                continue;
+            }
+
+            StyleChange change;
+            change.owner_id = record->owner_id;
+            change.taskbar_visible = WindowStyleManager::is_taskbar_visible(record->style);
+            change.clickable = WindowStyleManager::is_clickable(record->style);
+            changes.push_back(change);
+            HIDE_TASKBAR_TRACE(TRACE_LEVEL_INFO, TRACE_OP_STYLE_WATCH, record->window_id, true, "Window style changed externally");
+
+            if (auto_reassert) {
+                // 恢复之前记录的样式位，自己的写入在下一帧比较时与影子状态一致，不会再次触发
+                WindowStyleRequest request;
+                request.restore = true;
+                request.restore_style = expected;
+                request.restore_mask = mask;
+                if (manager.apply(&record, &request, 1) != 1) {
+                    HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_STYLE_WATCH, record->window_id, false, "Failed to reassert window style");
+                }
+            }
+        }
+        style_changes.swap(style_changes_deferred);
+    }
+
+    // 信号处理函数可能再次修改样式，发出前先释放锁
+    int count = 0;
+    for (const StyleChange& change : changes) {
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(change.owner_id)));
+        if (window) {
+            emit_signal("window_style_changed", window, change.taskbar_visible, change.clickable);
+            count++;
+        }
+    }
+    return count;
+}
+
+void HideTaskBarInWindowsSystem::_on_style_watch_process_frame() {
+    poll_style_changes();
+}
+
+// 窗口池
+// 池窗口是根Window下的无边框、透明、不获取焦点的置顶子窗口，一直保持显示，空闲时停放在屏幕外。
+// 支持显示前钩子的后端（Win32）在原生窗口第一次显示前写入池样式；其他后端在ready时写入。
+// 取出与归还只移动窗口并确认样式（影子状态一致时不访问系统），不会重建原生窗口。
+static const Vector2i POOL_PARK_POSITION = Vector2i(-32000, -32000);
+
+void HideTaskBarInWindowsSystem::configure_window_pool(int low_watermark, int grow_by, bool click_through) {
+    pool_low_watermark = std::max(low_watermark, 0);
+    pool_grow_by = std::max(grow_by, 1);
+    pool_click_through = click_through;
+    refill_pool();
 }
 
-bool HideTaskBarInWindowsSystem::is_window_visible_by_object(Window* window) {
-    UtilityFunctions::print("Current platform does not support checking window taskbar visibility status");
+int HideTaskBarInWindowsSystem::fill_window_pool(int count) {
+    TraceScope trace(TRACE_OP_POOL);
+    int created = 0;
+    for (int i = 0; i < count; i++) {
+        if (!create_pool_window()) {
+            break;
+        }
+        created++;
+    }
+    trace.finish(created == std::max(count, 0), "Window pool requires a SceneTree");
+    return created;
+}
+
+Window* HideTaskBarInWindowsSystem::acquire_pooled_window() {
+    TraceScope trace(TRACE_OP_POOL);
+    Window* window = nullptr;
+    while (!window && !pool_free.empty()) {
+        uint64_t object_id = pool_free.back();
+        pool_free.pop_back();
+        window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(object_id)));
+        if (window) {
+            pool_windows[object_id].state = POOL_IN_USE;
+        }
+    }
+
+    if (window) {
+        pool_hits++;
+        // 切换后端或被外部修改后样式可能不同，影子状态一致时不访问系统
+        submit_change(window, get_pool_request());
+    } else {
+        // 没有空闲窗口时新建一个，原生窗口在加入场景树后才创建
+        pool_misses++;
+        window = create_pool_window();
+        if (window) {
+            pool_windows[window->get_instance_id()].state = POOL_IN_USE;
+        }
+    }
+    if (window) {
+        pool_in_use++;
+    }
+
+    refill_pool();
+    return trace.finish(window != nullptr, "Window pool requires a SceneTree") ? window : nullptr;
+}
+
+bool HideTaskBarInWindowsSystem::release_pooled_window(Window* window) {
+    TraceScope trace(TRACE_OP_POOL);
+    if (!window) {
+        return trace.finish(false, "Window object is null");
+    }
+
+    uint64_t object_id = window->get_instance_id();
+    auto it = pool_windows.find(object_id);
+    if (it == pool_windows.end() || it->second.state != POOL_IN_USE) {
+        return trace.finish(false, "Window was not acquired from the pool");
+    }
+
+    park_pool_window(window);
+    pool_in_use--;
+    if (it->second.ready) {
+        submit_change(window, get_pool_request());
+        it->second.state = POOL_FREE;
+        pool_free.push_back(object_id);
+    } else {
+        it->second.state = POOL_PENDING;
+    }
+    return trace.finish(true);
+}
+
+void HideTaskBarInWindowsSystem::clear_window_pool() {
+    // 已取出的窗口交给调用者，不再属于池；其余窗口释放
+    for (const auto& pair : pool_windows) {
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(pair.first)));
+        if (!window) {
+            continue;
+        }
+        if (window->is_connected("ready", pair.second.on_ready)) {
+            window->disconnect("ready", pair.second.on_ready);
+        }
+        window->disconnect("tree_exiting", pair.second.on_tree_exiting);
+        if (pair.second.state == POOL_IN_USE) {
+            continue;
+        }
+        if (window->is_inside_tree()) {
+            window->queue_free();
+        } else {
+            // 还在等待延迟的add_child，排在它之后释放
+            window->call_deferred("queue_free");
+        }
+    }
+    pool_windows.clear();
+    pool_free.clear();
+    pool_not_ready = 0;
+    pool_in_use = 0;
+    update_show_hook();
+}
+
+Dictionary HideTaskBarInWindowsSystem::get_window_pool_stats() const {
+    Dictionary stats;
+    stats["size"] = (int64_t)pool_windows.size();
+    stats["free"] = (int64_t)pool_free.size();
+    stats["in_use"] = pool_in_use;
+    stats["pending"] = pool_not_ready;
+    stats["hits"] = pool_hits;
+    stats["misses"] = pool_misses;
+    stats["low_watermark"] = pool_low_watermark;
+    stats["grow_by"] = pool_grow_by;
+    return stats;
+}
+
+WindowStyleRequest HideTaskBarInWindowsSystem::get_pool_request() const {
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = false;
+    request.set_clickable = true;
+    request.clickable = !pool_click_through;
+    return request;
+}
+
+Window* HideTaskBarInWindowsSystem::create_pool_window() {
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    Window* root = tree ? tree->get_root() : nullptr;
+    if (!root) {
+        return nullptr;
+    }
+
+    Window* window = memnew(Window);
+    window->set_name("HideTaskbarPoolWindow");
+    window->set_flag(Window::FLAG_BORDERLESS, true);
+    window->set_flag(Window::FLAG_TRANSPARENT, true);
+    window->set_flag(Window::FLAG_NO_FOCUS, true);
+    window->set_flag(Window::FLAG_ALWAYS_ON_TOP, true);
+    window->set_transparent_background(true);
+    park_pool_window(window);
+
+    uint64_t object_id = window->get_instance_id();
+    PoolWindow pooled;
+    pooled.on_ready = callable_mp(this, &HideTaskBarInWindowsSystem::_on_pool_window_ready).bind(object_id);
+    pooled.on_tree_exiting = callable_mp(this, &HideTaskBarInWindowsSystem::_on_pool_window_tree_exiting).bind(object_id);
+    window->connect("ready", pooled.on_ready, CONNECT_ONE_SHOT);
+    window->connect("tree_exiting", pooled.on_tree_exiting);
+    pool_windows[object_id] = pooled;
+    pool_not_ready++;
+    update_show_hook();
+
+    // 根节点可能正在添加子节点（例如在_ready中调用），延迟加入场景树
+    root->call_deferred("add_child", window);
+    return window;
+}
+
+void HideTaskBarInWindowsSystem::park_pool_window(Window* window) {
+    window->set_position(POOL_PARK_POSITION);
+    window->set_size(Vector2i(1, 1));
+}
+
+void HideTaskBarInWindowsSystem::refill_pool() {
+    int available = (int)pool_free.size();
+    for (const auto& pair : pool_windows) {
+        available += pair.second.state == POOL_PENDING;
+    }
+    if (available >= pool_low_watermark) {
+        return;
+    }
+
+    int count = std::max(pool_grow_by, pool_low_watermark - available);
+    for (int i = 0; i < count; i++) {
+        if (!create_pool_window()) {
+            break;
+        }
+    }
+}
+
+void HideTaskBarInWindowsSystem::_on_pool_window_ready(uint64_t object_id) {
+    auto it = pool_windows.find(object_id);
+    if (it == pool_windows.end() || it->second.ready) {
+        return;
+    }
+    it->second.ready = true;
+    pool_not_ready--;
+    update_show_hook();
+
+    // 显示前钩子已经写入时这里只读取一次；没有钩子的后端（X11）在这里写入
+    Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(object_id)));
+    if (!window || !submit_change(window, get_pool_request())) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_POOL, TRACE_NO_WINDOW, false, "Failed to style pool window (are subwindows embedded?)");
+    }
+    if (it->second.state == POOL_PENDING) {
+        it->second.state = POOL_FREE;
+        pool_free.push_back(object_id);
+    }
+}
+
+void HideTaskBarInWindowsSystem::_on_pool_window_tree_exiting(uint64_t object_id) {
+    // 调用者释放了池窗口
+    auto it = pool_windows.find(object_id);
+    if (it == pool_windows.end()) {
+        return;
+    }
+    if (!it->second.ready) {
+        pool_not_ready--;
+    }
+    if (it->second.state == POOL_IN_USE) {
+        pool_in_use--;
+    } else if (it->second.state == POOL_FREE) {
+        pool_free.erase(std::remove(pool_free.begin(), pool_free.end(), object_id), pool_free.end());
+    }
+
+    Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(object_id)));
+    if (window) {
+        window->disconnect("tree_exiting", it->second.on_tree_exiting);
+    }
+    pool_windows.erase(it);
+    update_show_hook();
+}
+
+// 自动应用策略
+// 支持显示前钩子的后端（Win32）在窗口即将显示时通过DisplayServer找到对应的Window并匹配规则，
+// 样式在任务栏按钮创建前写入。其他后端在visibility_changed时应用（X11修改_NET_WM_STATE
+// 不需要重新映射窗口，不会闪烁）；队列模式下在本帧绘制前提交。
+int HideTaskBarInWindowsSystem::add_policy_rule(const String& match_by, const String& pattern, bool taskbar_visible, bool clickable) {
+    PolicyRule rule;
+    if (match_by == "group") {
+        rule.match_by = POLICY_MATCH_GROUP;
+    } else if (match_by == "class") {
+        rule.match_by = POLICY_MATCH_CLASS;
+    } else if (match_by == "name") {
+        rule.match_by = POLICY_MATCH_NAME;
+    } else {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_POLICY, TRACE_NO_WINDOW, false, "Unknown policy match type");
+        return -1;
+    }
+    rule.pattern = pattern;
+    rule.request.set_taskbar = true;
+    rule.request.taskbar_visible = taskbar_visible;
+    rule.request.set_clickable = true;
+    rule.request.clickable = clickable;
+    policy_rules.push_back(rule);
+
+    if (policy_enabled) {
+        scan_policy_windows();
+    }
+    return (int)policy_rules.size() - 1;
+}
+
+void HideTaskBarInWindowsSystem::clear_policy_rules() {
+    policy_rules.clear();
+    unwatch_policy_windows();
+    // 样式配置仍然有效时重新关联窗口
+    if (!style_profile.empty()) {
+        scan_policy_windows();
+    }
+}
+
+int HideTaskBarInWindowsSystem::get_policy_rule_count() const {
+    return (int)policy_rules.size();
+}
+
+void HideTaskBarInWindowsSystem::set_policy_enabled(bool enabled) {
+    if (enabled == policy_enabled) {
+        return;
+    }
+
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (enabled && !tree) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_POLICY, TRACE_NO_WINDOW, false, "Window policy requires a SceneTree");
+        return;
+    }
+
+    policy_enabled = enabled;
+    update_show_hook();
+    update_policy_watch();
+}
+
+bool HideTaskBarInWindowsSystem::is_policy_enabled() const {
+    return policy_enabled;
+}
+
+// 显示前钩子在启用策略或有尚未显示的池窗口时安装
+void HideTaskBarInWindowsSystem::update_show_hook() {
+    bool wanted = policy_enabled || !style_profile.empty() || pool_not_ready > 0;
+    if (wanted && !show_hooked) {
+        show_hooked = manager.get_backend()->set_show_hook(policy_show_hook, this);
+    } else if (!wanted && show_hooked) {
+        manager.get_backend()->set_show_hook(nullptr, nullptr);
+        show_hooked = false;
+    }
+}
+
+int HideTaskBarInWindowsSystem::match_policy_rule(Window* window) const {
+    for (size_t i = 0; i < policy_rules.size(); i++) {
+        const PolicyRule& rule = policy_rules[i];
+        switch (rule.match_by) {
+            case POLICY_MATCH_GROUP: {
+                TypedArray<StringName> groups = window->get_groups();
+                for (int64_t j = 0; j < groups.size(); j++) {
+                    if (String(groups[j]).match(rule.pattern)) {
+                        return (int)i;
+                    }
+                }
+            } break;
+            case POLICY_MATCH_CLASS:
+                // 精确类名包含父类（"Popup"匹配所有PopupMenu），通配符只匹配实际类名
+                if (window->is_class(rule.pattern) || window->get_class().match(rule.pattern)) {
+                    return (int)i;
+                }
+                break;
+            case POLICY_MATCH_NAME:
+                if (String(window->get_name()).match(rule.pattern)) {
+                    return (int)i;
+                }
+                break;
+        }
+    }
+    return -1;
+}
+
+// 样式配置优先于规则；规则只在启用策略时匹配
+bool HideTaskBarInWindowsSystem::match_window_request(Window* window, WindowStyleRequest& r_request) const {
+    if (!style_profile.empty()) {
+        auto it = style_profile.find(std::string(String(window->get_path()).utf8().get_data()));
+        if (it != style_profile.end()) {
+            r_request = it->second;
+            return true;
+        }
+    }
+    if (policy_enabled) {
+        int rule = match_policy_rule(window);
+        if (rule >= 0) {
+            r_request = policy_rules[rule].request;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 策略或样式配置需要时监听新加入场景树的窗口
+void HideTaskBarInWindowsSystem::update_policy_watch() {
+    bool wanted = policy_enabled || !style_profile.empty();
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (!node_added_callable.is_valid()) {
+        node_added_callable = callable_mp(this, &HideTaskBarInWindowsSystem::_on_node_added);
+    }
+    bool connected = tree && tree->is_connected("node_added", node_added_callable);
+
+    if (wanted) {
+        if (tree && !connected) {
+            tree->connect("node_added", node_added_callable);
+        }
+        scan_policy_windows();
+        return;
+    }
+    if (connected) {
+        tree->disconnect("node_added", node_added_callable);
+    }
+    unwatch_policy_windows();
+}
+
+void HideTaskBarInWindowsSystem::scan_policy_windows() {
+    // 启用策略、添加规则或载入样式配置前已经在场景树中的窗口，已经显示的一次批量提交
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    Window* root = tree ? tree->get_root() : nullptr;
+    if (!root) {
+        return;
+    }
+
+    TypedArray<Node> windows = root->find_children("*", "Window", true, false);
+
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowStyleBatch batch;
+    for (int64_t i = 0; i < windows.size(); i++) {
+        Window* window = Object::cast_to<Window>(windows[i]);
+        WindowStyleRequest request;
+        if (!window || !watch_policy_window(window, request)) {
+            continue;
+        }
+        WindowRecord* record = get_window_record(window);
+        if (record && queued_mode) {
+            manager.queue(*record, request);
+            schedule_flush();
+        } else {
+            batch.add(record, request);
+        }
+    }
+    if (batch.size() > 0) {
+        manager.apply(batch);
+    }
+}
+
+void HideTaskBarInWindowsSystem::unwatch_policy_windows() {
+    for (const auto& pair : policy_windows) {
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(pair.first)));
+        if (window) {
+            window->disconnect("visibility_changed", pair.second.on_visibility_changed);
+            window->disconnect("tree_exiting", pair.second.on_tree_exiting);
+        }
+    }
+    policy_windows.clear();
+}
+
+void HideTaskBarInWindowsSystem::_on_node_added(Node* node) {
+    Window* window = Object::cast_to<Window>(node);
+    WindowStyleRequest request;
+    if (window && watch_policy_window(window, request)) {
+        submit_change(window, request);
+    }
+}
+
+// 匹配的窗口监听可见性变化；返回true表示窗口已经显示（显示前钩子没有处理到），需要立即应用r_request
+bool HideTaskBarInWindowsSystem::watch_policy_window(Window* window, WindowStyleRequest& r_request) {
+    uint64_t object_id = window->get_instance_id();
+    auto it = policy_windows.find(object_id);
+    // 池窗口由窗口池管理样式
+    if (pool_windows.count(object_id) || !match_window_request(window, r_request)) {
+        // 规则或配置变化后不再匹配的窗口
+        if (it != policy_windows.end()) {
+            _on_policy_window_tree_exiting(object_id);
+        }
+        return false;
+    }
+
+    if (it != policy_windows.end()) {
+        it->second.request = r_request;
+    } else {
+        PolicyWindow watched;
+        watched.request = r_request;
+        watched.on_visibility_changed = callable_mp(this, &HideTaskBarInWindowsSystem::_on_policy_window_visibility_changed).bind(object_id);
+        watched.on_tree_exiting = callable_mp(this, &HideTaskBarInWindowsSystem::_on_policy_window_tree_exiting).bind(object_id);
+        window->connect("visibility_changed", watched.on_visibility_changed);
+        window->connect("tree_exiting", watched.on_tree_exiting);
+        policy_windows[object_id] = watched;
+    }
+    return window->is_visible() && window->get_window_id() >= 0;
+}
+
+void HideTaskBarInWindowsSystem::_on_policy_window_visibility_changed(uint64_t object_id) {
+    auto it = policy_windows.find(object_id);
+    Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(object_id)));
+    if (it == policy_windows.end() || !window || !window->is_visible() || window->get_window_id() < 0) {
+        return;
+    }
+
+    // 原生窗口可能刚刚重建，先丢弃旧缓存；钩子已经写入样式时这里只读取一次，不会重复修改
+    _on_window_invalidated(object_id);
+    submit_change(window, it->second.request);
+}
+
+void HideTaskBarInWindowsSystem::_on_policy_window_tree_exiting(uint64_t object_id) {
+    auto it = policy_windows.find(object_id);
+    if (it == policy_windows.end()) {
+        return;
+    }
+
+    Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(object_id)));
+    if (window) {
+        window->disconnect("visibility_changed", it->second.on_visibility_changed);
+        window->disconnect("tree_exiting", it->second.on_tree_exiting);
+    }
+    policy_windows.erase(it);
+}
+
+bool HideTaskBarInWindowsSystem::policy_show_hook(NativeWindowHandle handle, uint32_t current_style, uint32_t& r_style, void* userdata) {
+    HideTaskBarInWindowsSystem* self = (HideTaskBarInWindowsSystem*)userdata;
+    DisplayServer* display_server = DisplayServer::get_singleton();
+    if (!display_server) {
+        return false;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(self->manager_mutex);
+    // Window在创建原生窗口后、显示前就已经把自己的对象ID附加到窗口ID上
+    PackedInt32Array window_ids = display_server->get_window_list();
+    for (int64_t i = 0; i < window_ids.size(); i++) {
+        int32_t window_id = window_ids[i];
+        if (self->manager.lookup_handle((uint32_t)window_id) != handle) {
+            continue;
+        }
+
+        uint64_t object_id = display_server->window_get_attached_instance_id(window_id);
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(object_id)));
+
+        // 池窗口第一次显示时写入池样式，不会在任务栏中闪现
+        auto pooled = self->pool_windows.find(object_id);
+        if (window && pooled != self->pool_windows.end()) {
+            r_style = WindowStyleManager::compute_target_style(current_style, self->get_pool_request());
+            self->manager.invalidate((uint32_t)window_id, object_id);
+            return true;
+        }
+
+        WindowStyleRequest request;
+        if (!window || !self->match_window_request(window, request)) {
+            return false;
+        }
+
+        r_style = WindowStyleManager::compute_target_style(current_style, request);
+        // 样式在显示前被改写，缓存的影子状态作废
+        self->manager.invalidate((uint32_t)window_id, object_id);
+        return true;
+    }
+    return false;
+}
+
+// 样式配置
+// 格式见style_profile.h。载入后复用自动应用策略的监听与显示前钩子，
+// 窗口在原生窗口出现时直接写入最终样式（影子状态一致时不访问系统）。
+PackedByteArray HideTaskBarInWindowsSystem::save_style_profile() {
+    TraceScope trace(TRACE_OP_PROFILE);
+    // 配置中当前没有打开的窗口保留原来的条目
+    std::map<std::string, uint8_t> entries;
+    for (const auto& pair : style_profile) {
+        entries[pair.first] = StyleProfile::pack(pair.second);
+    }
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        for (const auto& pair : watched_windows) {
+            if (pool_windows.count(pair.first)) {
+                continue;
+            }
+            Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(pair.first)));
+            // 主窗口与运行时自动命名（路径中含@）的窗口没有稳定的路径
+            if (!window || pair.second.window_id == 0 || !window->is_inside_tree()) {
+                continue;
+            }
+            String path = window->get_path();
+            if (path.contains("@")) {
+                continue;
+            }
+            WindowRecord* record = manager.resolve(pair.second.window_id, pair.first);
+            if (!record || !manager.load_style(*record)) {
+                continue;
+            }
+            WindowStyleRequest request;
+            request.restore_style = record->style;
+            request.restore_mask = StyleProfile::STYLE_MASK;
+            entries[std::string(path.utf8().get_data())] = StyleProfile::pack(request);
+        }
+    }
+
+    PackedByteArray data;
+    data.resize((int64_t)StyleProfile::get_size(entries));
+    StyleProfile::write(entries, data.ptrw());
+    trace.finish(true);
+    return data;
+}
+
+bool HideTaskBarInWindowsSystem::load_style_profile(const PackedByteArray& data) {
+    TraceScope trace(TRACE_OP_PROFILE);
+    // 全部解析成功后才替换当前配置
+    switch (StyleProfile::parse(data.ptr(), (size_t)data.size(), style_profile)) {
+        case StyleProfile::OK:
+            break;
+        case StyleProfile::UNSUPPORTED_VERSION:
+            return trace.finish(false, "Unsupported style profile version");
+        case StyleProfile::TRUNCATED:
+            return trace.finish(false, "Truncated style profile");
+        default:
+            return trace.finish(false, "Invalid style profile");
+    }
+
+    update_show_hook();
+    update_policy_watch();
+    return trace.finish(true);
+}
+
+void HideTaskBarInWindowsSystem::clear_style_profile() {
+    if (style_profile.empty()) {
+        return;
+    }
+    style_profile.clear();
+    update_show_hook();
+    update_policy_watch();
+}
+
+int HideTaskBarInWindowsSystem::get_style_profile_size() const {
+    return (int)style_profile.size();
+}
+
+// 子窗口操作
+// 每个操作以TraceScope计时：成功记为DEBUG事件，失败记为WARNING事件（默认输出到Godot）
+bool HideTaskBarInWindowsSystem::hide(Window* window) {
+    TraceScope trace(TRACE_OP_HIDE);
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = false;
+    if (async_mode) {
+        // 异步提交失败时submit_async已经记录了原因
+        return trace.finish(submit_async(window, request) != 0, "Failed to hide window from taskbar");
+    }
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+    return trace.finish(submit_record(record, request), "Failed to hide window from taskbar");
+}
+
+bool HideTaskBarInWindowsSystem::show(Window* window) {
+    TraceScope trace(TRACE_OP_SHOW);
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = true;
+    if (async_mode) {
+        // 异步提交失败时submit_async已经记录了原因
+        return trace.finish(submit_async(window, request) != 0, "Failed to show window on taskbar");
+    }
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+    return trace.finish(submit_record(record, request), "Failed to show window on taskbar");
+}
+
+bool HideTaskBarInWindowsSystem::is_visible(Window* window) {
+    TraceScope trace(TRACE_OP_IS_VISIBLE);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+
+    if (trace.finish(record && manager.load_style(*record), "Unable to determine window visibility on taskbar")) {
+        // 直接使用影子状态判断，不访问系统
+        return WindowStyleManager::is_taskbar_visible(record->style);
+    }
+    return false;
+}
+
+bool HideTaskBarInWindowsSystem::set_clickable(Window* window, bool clickable) {
+    TraceScope trace(TRACE_OP_SET_CLICKABLE);
+    WindowStyleRequest request;
+    request.set_clickable = true;
+    request.clickable = clickable;
+    if (async_mode) {
+        // 蒙版在主线程取回结果时丢弃
+        return trace.finish(submit_async(window, request) != 0, "Failed to set window click-through property");
+    }
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+    if (submit_record(record, request)) {
+        // X11下整窗穿透与点击区域共用输入区域，之后的蒙版需要重新提交
+        click_masks.erase(window->get_instance_id());
+        return trace.finish(true);
+    }
+    return trace.finish(false, "Failed to set window click-through property");
+}
+
+bool HideTaskBarInWindowsSystem::is_clickable(Window* window) {
+    TraceScope trace(TRACE_OP_IS_CLICKABLE);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+
+    if (trace.finish(record && manager.load_style(*record), "Unable to determine window clickability")) {
+        // 检查是否设置了穿透样式（来自影子状态）
+        return WindowStyleManager::is_clickable(record->style);
+    }
+    return true; // 默认认为是可点击的
+}
+
+// 点击区域蒙版
+// 透明度 >= threshold 的像素（或多边形内部）可点击，其余部分鼠标穿透，坐标以窗口左上角为原点。
+// 蒙版转换为矩形列表后一次提交：Windows下为SetWindowRgn（同时裁剪绘制），X11下为XShape输入区域。
+// 每个窗口保存上一次的位集与每行区间，只有区域变化时才调用系统。
+// 蒙版不经过队列模式，调用时立即生效；set_clickable或原生窗口重建后下一次调用会重新提交。
+bool HideTaskBarInWindowsSystem::set_click_through_mask(Window* window, const Ref<Image>& image, int threshold, const Rect2i& dirty_rect) {
+    TraceScope trace(TRACE_OP_CLICK_MASK);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+    if (!record) {
+        return trace.finish(false, "Failed to set click-through mask");
+    }
+
+    PackedByteArray data;
+    int32_t width = 0;
+    int32_t height = 0;
+    ClickMaskFormat format = CLICK_MASK_RGBA8;
+    int32_t bytes_per_pixel = 4;
+    const char* error = read_mask_image(image, data, width, height, format, bytes_per_pixel);
+    if (error) {
+        return trace.finish(false, error);
+    }
+
+    MaskRect dirty;
+    if (dirty_rect.has_area()) {
+        dirty.x = dirty_rect.position.x;
+        dirty.y = dirty_rect.position.y;
+        dirty.width = dirty_rect.size.x;
+        dirty.height = dirty_rect.size.y;
+    }
+
+    ClickMask& mask = click_masks[window->get_instance_id()];
+    if (!mask.update(data.ptr(), width, height, (size_t)width * bytes_per_pixel, format,
+                     (uint8_t)std::min(std::max(threshold, 0), 255), dirty_rect.has_area() ? &dirty : nullptr)) {
+        stats_record_redundant();
+        return trace.finish(true); // 区域没有变化
+    }
+    return trace.finish(apply_click_mask(window, record, mask), "Failed to set click-through mask");
+}
+
+bool HideTaskBarInWindowsSystem::set_click_through_polygon(Window* window, const PackedVector2Array& polygon) {
+    TraceScope trace(TRACE_OP_CLICK_MASK);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+    if (!record) {
+        return trace.finish(false, "Failed to set click-through mask");
+    }
+    if (polygon.size() < 3) {
+        return trace.finish(false, "Click-through polygon needs at least 3 points");
+    }
+
+    std::vector<float> points;
+    points.reserve(polygon.size() * 2);
+    for (int64_t i = 0; i < polygon.size(); i++) {
+        Vector2 point = polygon[i];
+        points.push_back((float)point.x);
+        points.push_back((float)point.y);
+    }
+
+    Vector2i size = window->get_size();
+    ClickMask& mask = click_masks[window->get_instance_id()];
+    if (!mask.build_polygon(points.data(), polygon.size(), size.x, size.y)) {
+        stats_record_redundant();
+        return trace.finish(true); // 区域没有变化
+    }
+    return trace.finish(apply_click_mask(window, record, mask), "Failed to set click-through mask");
+}
+
+bool HideTaskBarInWindowsSystem::clear_click_through_mask(Window* window) {
+    TraceScope trace(TRACE_OP_CLICK_MASK);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+    if (record && manager.get_backend()->clear_input_region(record->handle)) {
+        click_masks.erase(window->get_instance_id());
+        return trace.finish(true);
+    }
+    return trace.finish(false, "Failed to clear click-through mask");
+}
+
+Ref<Image> HideTaskBarInWindowsSystem::convert_click_mask(const Ref<Image>& image) {
+    TraceScope trace(TRACE_OP_CLICK_MASK, TRACE_NO_WINDOW);
+    PackedByteArray data;
+    int32_t width = 0;
+    int32_t height = 0;
+    ClickMaskFormat format = CLICK_MASK_RGBA8;
+    int32_t bytes_per_pixel = 4;
+    const char* error = read_mask_image(image, data, width, height, format, bytes_per_pixel);
+    if (error) {
+        trace.finish(false, error);
+        return Ref<Image>();
+    }
+    if (format == CLICK_MASK_ALPHA8) {
+        trace.finish(true);
+        return image; // L8/R8已经是快速路径
+    }
+
+    PackedByteArray alpha;
+    alpha.resize((int64_t)width * height);
+    ClickMask::extract_alpha(data.ptr(), width, height, (size_t)width * bytes_per_pixel, format, alpha.ptrw());
+    trace.finish(true);
+    return Image::create_from_data(width, height, false, Image::FORMAT_L8, alpha);
+}
+
+bool HideTaskBarInWindowsSystem::apply_click_mask(Window* window, WindowRecord* record, ClickMask& mask) {
+    const std::vector<MaskRect>& rects = mask.get_rects();
+    if (manager.get_backend()->set_input_region(record->handle, rects.data(), rects.size())) {
+        return true;
+    }
+
+    // 提交失败时丢弃保存的蒙版，下一次调用重新提交
+    click_masks.erase(window->get_instance_id());
+    return false;
+}
+
+// 悬停穿透
+// 蒙版/多边形先转换为点击区域矩形，再展开为每像素1位的位集，跟踪线程每次检查只需一次查表。
+// 跟踪线程在有窗口时运行，结果每帧在主线程取回（SceneTree的process_frame信号）。
+bool HideTaskBarInWindowsSystem::set_hover_mask(Window* window, const Ref<Image>& image, int threshold) {
+    TraceScope trace(TRACE_OP_HOVER);
+    PackedByteArray data;
+    int32_t width = 0;
+    int32_t height = 0;
+    ClickMaskFormat format = CLICK_MASK_RGBA8;
+    int32_t bytes_per_pixel = 4;
+    const char* error = read_mask_image(image, data, width, height, format, bytes_per_pixel);
+    if (error) {
+        return trace.finish(false, error);
+    }
+
+    ClickMask mask;
+    mask.build(data.ptr(), width, height, (size_t)width * bytes_per_pixel, format, (uint8_t)std::min(std::max(threshold, 0), 255));
+    uint32_t window_id = TRACE_NO_WINDOW;
+    bool ok = start_hover(window, mask.get_rects(), width, height, window_id);
+    trace.set_window_id(window_id);
+    return trace.finish(ok, "Failed to set hover region");
+}
+
+bool HideTaskBarInWindowsSystem::set_hover_polygon(Window* window, const PackedVector2Array& polygon) {
+    TraceScope trace(TRACE_OP_HOVER);
+    if (!window || polygon.size() < 3) {
+        return trace.finish(false, "Hover polygon needs at least 3 points");
+    }
+
+    std::vector<float> points;
+    points.reserve(polygon.size() * 2);
+    for (int64_t i = 0; i < polygon.size(); i++) {
+        Vector2 point = polygon[i];
+        points.push_back((float)point.x);
+        points.push_back((float)point.y);
+    }
+
+    Vector2i size = window->get_size();
+    ClickMask mask;
+    mask.build_polygon(points.data(), polygon.size(), size.x, size.y);
+    uint32_t window_id = TRACE_NO_WINDOW;
+    bool ok = start_hover(window, mask.get_rects(), size.x, size.y, window_id);
+    trace.set_window_id(window_id);
+    return trace.finish(ok, "Failed to set hover region");
+}
+
+bool HideTaskBarInWindowsSystem::clear_hover(Window* window) {
+    TraceScope trace(TRACE_OP_HOVER);
+    if (!window) {
+        return trace.finish(false, "Window object is null");
+    }
+    // 保持最后一次写入的穿透状态
+    bool removed = hover_tracker.remove_window(window->get_instance_id());
+    if (hover_tracker.get_window_count() == 0) {
+        stop_hover();
+    }
+    return trace.finish(removed, "Window has no hover region");
+}
+
+void HideTaskBarInWindowsSystem::set_hover_interval(int msec) {
+    hover_tracker.set_interval_ms(msec);
+}
+
+int HideTaskBarInWindowsSystem::get_hover_interval() const {
+    return hover_tracker.get_interval_ms();
+}
+
+bool HideTaskBarInWindowsSystem::start_hover(Window* window, const std::vector<MaskRect>& rects, int32_t width, int32_t height, uint32_t& r_window_id) {
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        WindowRecord* record = get_window_record(window);
+        r_window_id = trace_record_id(record);
+        if (!record) {
+            return false;
+        }
+
+        std::shared_ptr<HoverRegion> region = std::make_shared<HoverRegion>();
+        region->build(rects.data(), rects.size(), width, height);
+        // 悬停切换的是整窗穿透，保存的点击区域蒙版不再有效
+        click_masks.erase(window->get_instance_id());
+        hover_tracker.set_window(record->window_id, window->get_instance_id(), region);
+    }
+
+    if (!hover_tracker.is_running()) {
+        hover_tracker.start();
+        SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+        if (!hover_poll_callable.is_valid()) {
+            hover_poll_callable = callable_mp(this, &HideTaskBarInWindowsSystem::_on_hover_process_frame);
+        }
+        if (tree && !tree->is_connected("process_frame", hover_poll_callable)) {
+            tree->connect("process_frame", hover_poll_callable);
+        }
+    }
+    return true;
+}
+
+void HideTaskBarInWindowsSystem::stop_hover() {
+    // 跟踪线程可能在等待manager_mutex，调用时不能持有该锁
+    hover_tracker.stop();
+    hover_tracker.clear();
+
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (tree && hover_poll_callable.is_valid() && tree->is_connected("process_frame", hover_poll_callable)) {
+        tree->disconnect("process_frame", hover_poll_callable);
+    }
+    HoverEvent event;
+    while (hover_tracker.poll_event(event)) {
+    }
+}
+
+int HideTaskBarInWindowsSystem::poll_hover_events() {
+    int count = 0;
+    HoverEvent event;
+    while (hover_tracker.poll_event(event)) {
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(event.owner_id)));
+        if (!window || !event.ok) {
+            continue;
+        }
+
+        {
+            // 跟踪线程解析的记录在主线程补上失效信号
+            std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+            WindowRecord* record = manager.find(event.window_id, event.owner_id);
+            if (record && !record->watched) {
+                watch_window(window, event.window_id);
+                record->watched = true;
+            }
+        }
+        count++;
+        emit_signal("hover_changed", window, event.hovered);
+    }
+    return count;
+}
+
+void HideTaskBarInWindowsSystem::_on_hover_process_frame() {
+    poll_hover_events();
+}
+
+// 不透明度与渐变
+// 不透明度有影子状态，重复设置相同的值不访问系统。渐变线程只在有渐变时运行，结果每帧在主线程取回。
+static uint8_t to_opacity_byte(float opacity) {
+    return (uint8_t)std::lround(std::min(std::max(opacity, 0.0f), 1.0f) * 255.0f);
+}
+
+bool HideTaskBarInWindowsSystem::set_opacity(Window* window, float opacity) {
+    TraceScope trace(TRACE_OP_OPACITY);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+    if (!record) {
+        return trace.finish(false, "Failed to set window opacity");
+    }
+
+    // 正在进行的渐变停在当前值，再写入新值
+    fader.cancel(window->get_instance_id());
+    uint8_t value = to_opacity_byte(opacity);
+    return trace.finish(manager.set_opacity(&record, &value, 1) == 1, "Failed to set window opacity");
+}
+
+float HideTaskBarInWindowsSystem::get_opacity(Window* window) {
+    TraceScope trace(TRACE_OP_OPACITY);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+
+    if (trace.finish(record && manager.load_opacity(*record), "Unable to determine window opacity")) {
+        return record->opacity / 255.0f;
+    }
+    return 1.0f;
+}
+
+bool HideTaskBarInWindowsSystem::fade(Window* window, float opacity, float duration) {
+    TraceScope trace(TRACE_OP_OPACITY);
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        WindowRecord* record = get_window_record(window);
+        trace.set_window_id(trace_record_id(record));
+        if (!record) {
+            return trace.finish(false, "Failed to start window fade");
+        }
+        fader.fade(record->window_id, window->get_instance_id(), to_opacity_byte(opacity), (int64_t)(std::max(duration, 0.0f) * 1000000.0));
+    }
+    start_fader();
+    return trace.finish(true);
+}
+
+void HideTaskBarInWindowsSystem::start_fader() {
+    // 渐变线程在有窗口时运行，结果每帧在主线程取回
+    if (fader.is_running()) {
+        return;
+    }
+    fader.start();
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (!fade_poll_callable.is_valid()) {
+        fade_poll_callable = callable_mp(this, &HideTaskBarInWindowsSystem::_on_fade_process_frame);
+    }
+    if (tree && !tree->is_connected("process_frame", fade_poll_callable)) {
+        tree->connect("process_frame", fade_poll_callable);
+    }
+}
+
+bool HideTaskBarInWindowsSystem::cancel_fade(Window* window) {
+    TraceScope trace(TRACE_OP_OPACITY);
+    if (!window) {
+        return trace.finish(false, "Window object is null");
+    }
+    return trace.finish(fader.cancel(window->get_instance_id()), "Window has no active fade");
+}
+
+void HideTaskBarInWindowsSystem::stop_fades() {
+    // 渐变线程可能在等待manager_mutex，调用时不能持有该锁
+    fader.stop();
+    fader.clear();
+
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (tree && fade_poll_callable.is_valid() && tree->is_connected("process_frame", fade_poll_callable)) {
+        tree->disconnect("process_frame", fade_poll_callable);
+    }
+    FadeEvent event;
+    while (fader.poll_event(event)) {
+    }
+}
+
+int HideTaskBarInWindowsSystem::poll_fade_events() {
+    int count = 0;
+    FadeEvent event;
+    while (fader.poll_event(event)) {
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(event.owner_id)));
+        if (!window) {
+            continue;
+        }
+
+        {
+            // 渐变线程解析的记录在主线程补上失效信号
+            std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+            WindowRecord* record = manager.find(event.window_id, event.owner_id);
+            if (record && !record->watched) {
+                watch_window(window, event.window_id);
+                record->watched = true;
+            }
+        }
+        count++;
+        emit_signal("fade_finished", window, event.completed);
+    }
+    return count;
+}
+
+void HideTaskBarInWindowsSystem::_on_fade_process_frame() {
+    poll_fade_events();
+}
+
+int64_t HideTaskBarInWindowsSystem::get_window_system_handle(Window* window) {
+    TraceScope trace(TRACE_OP_GET_HANDLE);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_window_record(window);
+    trace.set_window_id(trace_record_id(record));
+
+    if (trace.finish(record != nullptr, "Failed to retrieve system handle")) {
+        return record->handle;
+    }
+    return 0; // 返回0表示无效句柄
+}
+
+// 窗口ID
+// 槽位记录所属对象ID与最近一次解析到的窗口ID。按ID操作时按下标取槽位，再按窗口ID在句柄缓存（哈希表）中查找记录：
+// 记录属于同一对象并且已经监听失效信号时直接使用，不调用Godot；原生窗口重建（记录失效）
+// 或窗口ID被其他窗口复用时，通过Window对象重新解析一次。
+
+int64_t HideTaskBarInWindowsSystem::register_window(Window* window) {
+    TraceScope trace(TRACE_OP_WINDOW_ID);
+    if (!window) {
+        trace.finish(false, "Window object is null");
+        return WindowSlotTable::INVALID_ID;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    uint64_t object_id = window->get_instance_id();
+    auto it = registered_windows.find(object_id);
+    if (it != registered_windows.end()) {
+        trace.finish(true);
+        return it->second.id;
+    }
+
+    RegisteredWindow registered;
+    registered.id = window_slots.add(object_id);
+    registered.on_tree_exiting = callable_mp(this, &HideTaskBarInWindowsSystem::_on_registered_window_tree_exiting).bind(object_id);
+    window->connect("tree_exiting", registered.on_tree_exiting);
+    registered_windows[object_id] = registered;
+
+    // 已经有原生窗口时立即解析，第一次按ID操作就走快速路径
+    if (window->get_window_id() >= 0) {
+        WindowRecord* record = get_window_record(window);
+        trace.set_window_id(trace_record_id(record));
+        if (record) {
+            window_slots.get(registered.id)->window_id = record->window_id;
+        }
+    }
+    trace.finish(true);
+    return registered.id;
+}
+
+bool HideTaskBarInWindowsSystem::unregister_window(int64_t id) {
+    TraceScope trace(TRACE_OP_WINDOW_ID);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowSlot* slot = window_slots.get(id);
+    if (!slot) {
+        return trace.finish(false, "Invalid window ID");
+    }
+
+    auto it = registered_windows.find(slot->owner_id);
+    if (it != registered_windows.end()) {
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(slot->owner_id)));
+        if (window) {
+            window->disconnect("tree_exiting", it->second.on_tree_exiting);
+        }
+        registered_windows.erase(it);
+    }
+    return trace.finish(window_slots.remove(id));
+}
+
+void HideTaskBarInWindowsSystem::unregister_all_windows() {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    for (const auto& pair : registered_windows) {
+        Window* window = Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(pair.first)));
+        if (window) {
+            window->disconnect("tree_exiting", pair.second.on_tree_exiting);
+        }
+    }
+    registered_windows.clear();
+    window_slots.clear();
+}
+
+void HideTaskBarInWindowsSystem::_on_registered_window_tree_exiting(uint64_t object_id) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    auto it = registered_windows.find(object_id);
+    if (it != registered_windows.end()) {
+        unregister_window(it->second.id);
+    }
+}
+
+bool HideTaskBarInWindowsSystem::is_window_id_valid(int64_t id) const {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    return window_slots.get(id) != nullptr;
+}
+
+Window* HideTaskBarInWindowsSystem::get_window_by_id(int64_t id) const {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    const WindowSlot* slot = window_slots.get(id);
+    return slot ? Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(slot->owner_id))) : nullptr;
+}
+
+WindowRecord* HideTaskBarInWindowsSystem::get_slot_record(int64_t id) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowSlot* slot = window_slots.get(id);
+    if (!slot) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_RESOLVE, TRACE_NO_WINDOW, false, "Invalid window ID");
+        return nullptr;
+    }
+
+    // 未监听失效信号的记录（异步执行器解析的）可能已经过期，不能直接使用
+    if (slot->window_id != WindowSlot::NO_WINDOW) {
+        WindowRecord* record = manager.find(slot->window_id, slot->owner_id);
+        if (record && record->watched) {
+            return record;
+        }
+    }
+
+    WindowRecord* record = get_window_record(Object::cast_to<Window>(ObjectDB::get_instance(ObjectID(slot->owner_id))));
+    slot->window_id = record ? record->window_id : WindowSlot::NO_WINDOW;
+    return record;
+}
+
+Window* HideTaskBarInWindowsSystem::get_slot_window(int64_t id) {
+    Window* window = get_window_by_id(id);
+    if (!window) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_RESOLVE, TRACE_NO_WINDOW, false, "Invalid window ID");
+    }
+    return window;
+}
+
+bool HideTaskBarInWindowsSystem::submit_slot_change(WindowRecord* record, const WindowStyleRequest& request) {
+    if (record && async_mode) {
+        return executor.submit(record->window_id, record->owner_id, request) != 0;
+    }
+    return submit_record(record, request);
+}
+
+bool HideTaskBarInWindowsSystem::hide_id(int64_t id) {
+    TraceScope trace(TRACE_OP_HIDE);
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = false;
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_slot_record(id);
+    trace.set_window_id(trace_record_id(record));
+    return trace.finish(submit_slot_change(record, request), "Failed to hide window from taskbar");
+}
+
+bool HideTaskBarInWindowsSystem::show_id(int64_t id) {
+    TraceScope trace(TRACE_OP_SHOW);
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = true;
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_slot_record(id);
+    trace.set_window_id(trace_record_id(record));
+    return trace.finish(submit_slot_change(record, request), "Failed to show window on taskbar");
+}
+
+bool HideTaskBarInWindowsSystem::is_visible_id(int64_t id) {
+    TraceScope trace(TRACE_OP_IS_VISIBLE);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_slot_record(id);
+    trace.set_window_id(trace_record_id(record));
+
+    if (trace.finish(record && manager.load_style(*record), "Unable to determine window visibility on taskbar")) {
+        return WindowStyleManager::is_taskbar_visible(record->style);
+    }
+    return false;
+}
+
+bool HideTaskBarInWindowsSystem::set_clickable_id(int64_t id, bool clickable) {
+    TraceScope trace(TRACE_OP_SET_CLICKABLE);
+    WindowStyleRequest request;
+    request.set_clickable = true;
+    request.clickable = clickable;
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_slot_record(id);
+    trace.set_window_id(trace_record_id(record));
+    if (!submit_slot_change(record, request)) {
+        return trace.finish(false, "Failed to set window click-through property");
+    }
+    // 与set_clickable相同，异步模式下蒙版在主线程取回结果时丢弃
+    if (!async_mode) {
+        click_masks.erase(record->owner_id);
+    }
+    return trace.finish(true);
+}
+
+bool HideTaskBarInWindowsSystem::is_clickable_id(int64_t id) {
+    TraceScope trace(TRACE_OP_IS_CLICKABLE);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_slot_record(id);
+    trace.set_window_id(trace_record_id(record));
+
+    if (trace.finish(record && manager.load_style(*record), "Unable to determine window clickability")) {
+        return WindowStyleManager::is_clickable(record->style);
+    }
+    return true;
+}
+
+bool HideTaskBarInWindowsSystem::set_opacity_id(int64_t id, float opacity) {
+    TraceScope trace(TRACE_OP_OPACITY);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_slot_record(id);
+    trace.set_window_id(trace_record_id(record));
+    if (!record) {
+        return trace.finish(false, "Failed to set window opacity");
+    }
+
+    fader.cancel(record->owner_id);
+    uint8_t value = to_opacity_byte(opacity);
+    return trace.finish(manager.set_opacity(&record, &value, 1) == 1, "Failed to set window opacity");
+}
+
+float HideTaskBarInWindowsSystem::get_opacity_id(int64_t id) {
+    TraceScope trace(TRACE_OP_OPACITY);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_slot_record(id);
+    trace.set_window_id(trace_record_id(record));
+
+    if (trace.finish(record && manager.load_opacity(*record), "Unable to determine window opacity")) {
+        return record->opacity / 255.0f;
+    }
+    return 1.0f;
+}
+
+bool HideTaskBarInWindowsSystem::fade_id(int64_t id, float opacity, float duration) {
+    TraceScope trace(TRACE_OP_OPACITY);
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        WindowRecord* record = get_slot_record(id);
+        trace.set_window_id(trace_record_id(record));
+        if (!record) {
+            return trace.finish(false, "Failed to start window fade");
+        }
+        fader.fade(record->window_id, record->owner_id, to_opacity_byte(opacity), (int64_t)(std::max(duration, 0.0f) * 1000000.0));
+    }
+    start_fader();
+    return trace.finish(true);
+}
+
+bool HideTaskBarInWindowsSystem::cancel_fade_id(int64_t id) {
+    TraceScope trace(TRACE_OP_OPACITY);
+    uint64_t owner_id = 0;
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        const WindowSlot* slot = window_slots.get(id);
+        if (!slot) {
+            return trace.finish(false, "Invalid window ID");
+        }
+        owner_id = slot->owner_id;
+    }
+    return trace.finish(fader.cancel(owner_id), "Window has no active fade");
+}
+
+// 蒙版与悬停区域：转发给Window版本（各自记录诊断事件）
+bool HideTaskBarInWindowsSystem::set_click_through_mask_id(int64_t id, const Ref<Image>& image, int threshold, const Rect2i& dirty_rect) {
+    Window* window = get_slot_window(id);
+    return window && set_click_through_mask(window, image, threshold, dirty_rect);
+}
+
+bool HideTaskBarInWindowsSystem::set_click_through_polygon_id(int64_t id, const PackedVector2Array& polygon) {
+    Window* window = get_slot_window(id);
+    return window && set_click_through_polygon(window, polygon);
+}
+
+bool HideTaskBarInWindowsSystem::clear_click_through_mask_id(int64_t id) {
+    Window* window = get_slot_window(id);
+    return window && clear_click_through_mask(window);
+}
+
+bool HideTaskBarInWindowsSystem::set_hover_mask_id(int64_t id, const Ref<Image>& image, int threshold) {
+    Window* window = get_slot_window(id);
+    return window && set_hover_mask(window, image, threshold);
+}
+
+bool HideTaskBarInWindowsSystem::set_hover_polygon_id(int64_t id, const PackedVector2Array& polygon) {
+    Window* window = get_slot_window(id);
+    return window && set_hover_polygon(window, polygon);
+}
+
+bool HideTaskBarInWindowsSystem::clear_hover_id(int64_t id) {
+    Window* window = get_slot_window(id);
+    return window && clear_hover(window);
+}
+
+Dictionary HideTaskBarInWindowsSystem::query_window_states_by_id(const PackedInt64Array& ids) {
+    TraceScope trace(TRACE_OP_QUERY);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+
+    int64_t count = ids.size();
+    const int64_t* id_data = ids.ptr();
+    PackedInt64Array handles;
+    PackedByteArray states;
+    handles.resize(count);
+    states.resize(count);
+    int64_t* handle_data = handles.ptrw();
+    uint8_t* state_data = states.ptrw();
+
+    int valid = 0;
+    for (int64_t i = 0; i < count; i++) {
+        WindowRecord* record = get_slot_record(id_data[i]);
+        state_data[i] = read_window_state(record);
+        handle_data[i] = state_data[i] ? record->handle : 0;
+        valid += state_data[i] ? 1 : 0;
+    }
+
+    Dictionary result;
+    result["handles"] = handles;
+    result["states"] = states;
+    trace.finish(valid == count, "Some window states could not be read");
+    return result;
+}
+
+// 主窗口相关方法
+// 主窗口句柄只查找一次并缓存在窗口ID 0下。有场景树时以根Window为所属对象，
+// 与子窗口一样在重建或离开场景树时失效；DisplayServer查不到时由后端备用查找。
+WindowRecord* HideTaskBarInWindowsSystem::get_main_window_record() {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    Window* root = tree ? tree->get_root() : nullptr;
+    if (root) {
+        return get_window_record(root);
+    }
+
+    // 没有场景树时没有可监听的对象，所属对象ID记为0
+    bool inserted = false;
+    WindowRecord* record = manager.resolve(WindowStyleManager::MAIN_WINDOW_ID, 0, &inserted);
+    if (!record) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_RESOLVE, WindowStyleManager::MAIN_WINDOW_ID, false, "Failed to find main window handle");
+        return nullptr;
+    }
+    if (inserted) {
+        HIDE_TASKBAR_TRACE(TRACE_LEVEL_DEBUG, TRACE_OP_RESOLVE, WindowStyleManager::MAIN_WINDOW_ID, true, "Got main window handle");
+    }
+    return record;
+}
+
+bool HideTaskBarInWindowsSystem::hide_main_window() {
+    TraceScope trace(TRACE_OP_HIDE, WindowStyleManager::MAIN_WINDOW_ID);
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = false;
+    return trace.finish(async_mode ? submit_main_window_async(request) != 0 : submit_record(get_main_window_record(), request),
+                        "Failed to hide main window from taskbar");
+}
+
+bool HideTaskBarInWindowsSystem::show_main_window() {
+    TraceScope trace(TRACE_OP_SHOW, WindowStyleManager::MAIN_WINDOW_ID);
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = true;
+    return trace.finish(async_mode ? submit_main_window_async(request) != 0 : submit_record(get_main_window_record(), request),
+                        "Failed to show main window on taskbar");
+}
+
+bool HideTaskBarInWindowsSystem::is_main_window_visible() {
+    TraceScope trace(TRACE_OP_IS_VISIBLE, WindowStyleManager::MAIN_WINDOW_ID);
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    WindowRecord* record = get_main_window_record();
+
+    if (trace.finish(record && manager.load_style(*record), "Unable to determine main window visibility on taskbar")) {
+        return WindowStyleManager::is_taskbar_visible(record->style);
+    }
     return false;
 }
-#endif
\ No newline at end of file
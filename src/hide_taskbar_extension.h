@@ -1,14 +1,27 @@
 #ifndef HIDE_TASKBAR_EXTENSION_H
 #define HIDE_TASKBAR_EXTENSION_H
 
-#ifdef _WIN32
-#include <windows.h>
-#endif
+#include "window_style_manager.h"
+#include "click_mask.h"
+#include "window_executor.h"
+#include "hover_tracker.h"
+#include "window_fader.h"
+#include "window_slot_table.h"
+#include "style_profile.h"
 
 #include <godot_cpp/classes/object.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/classes/window.hpp>
 #include <godot_cpp/classes/display_server.hpp>
+#include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/classes/image.hpp>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 using namespace godot;
 
@@ -26,7 +39,7 @@ public:
     bool hide(Window* window);
     bool show(Window* window);
     bool is_visible(Window* window);
-    
+
     // 主窗口相关方法
     bool hide_main_window();
     bool show_main_window();
@@ -35,19 +48,319 @@ public:
     bool set_clickable(Window* window, bool clickable);
     bool is_clickable(Window* window);
 
+    // 点击区域蒙版 - 只有蒙版内的部分接收鼠标，其余部分穿透
+    // 每个窗口保存上一次的蒙版，动画蒙版逐帧调用时只处理变化的行，区域不变时不调用系统；
+    // dirty_rect为可选的变化范围提示（图像坐标），为空时比较整张图
+    bool set_click_through_mask(Window* window, const Ref<Image>& image, int threshold = 128, const Rect2i& dirty_rect = Rect2i());
+    bool set_click_through_polygon(Window* window, const PackedVector2Array& polygon);
+    bool clear_click_through_mask(Window* window);
+    // 取出蒙版的透明度通道，返回FORMAT_L8图像。RGBA8蒙版每次提交都要读取4倍的数据（4K约4ms），
+    // 不变或预先生成的蒙版转换一次后反复提交L8图像（4K约0.6ms）
+    Ref<Image> convert_click_mask(const Ref<Image>& image);
+
+    // 悬停穿透 - 光标位于区域（蒙版或多边形）内时窗口可点击，否则鼠标穿透，用于桌面宠物等悬浮窗口。
+    // 由专用线程每hover_interval毫秒检查一次光标，只在悬停状态变化时切换穿透样式（Windows下只切换WS_EX_TRANSPARENT），
+    // 并在主线程发出hover_changed(window, hovered)信号。开启期间set_clickable与点击区域蒙版会被下一次变化覆盖；
+    // 切换后端或清空句柄缓存时所有悬停区域一并清除。
+    bool set_hover_mask(Window* window, const Ref<Image>& image, int threshold = 128);
+    bool set_hover_polygon(Window* window, const PackedVector2Array& polygon);
+    bool clear_hover(Window* window);
+    void set_hover_interval(int msec);
+    int get_hover_interval() const;
+    int poll_hover_events();
+
+    // 窗口整体不透明度（0~1）- Windows下为分层窗口的透明度，X11下为_NET_WM_WINDOW_OPACITY（需要合成器），
+    // 由系统混合，不重新绘制窗口内容。set_clickable不会改变已设置的不透明度；原生窗口重建后恢复为1。
+    // fade由扩展内部的渐变线程推进（约60Hz），结束时在主线程发出fade_finished(window, completed)信号，
+    // 被新的fade/set_opacity替换或cancel_fade时completed为false。不经过队列与异步模式，调用时立即生效。
+    bool set_opacity(Window* window, float opacity);
+    float get_opacity(Window* window);
+    bool fade(Window* window, float opacity, float duration);
+    bool cancel_fade(Window* window);
+    int poll_fade_events();
+
+    // 外部样式变化通知 - 受管理窗口的任务栏/穿透状态被其他程序修改时发出
+    // window_style_changed(window, taskbar_visible, clickable)，不需要每帧轮询is_visible/is_clickable。
+    // Windows下由窗口线程的消息钩子接收WM_STYLECHANGED，X11下监听_NET_WM_STATE的PropertyNotify与输入区域的ShapeNotify；
+    // 每帧在主线程取回并与影子状态比较，本扩展自己的写入不会触发。
+    // auto_reassert开启时立即恢复为扩展记录的状态（最后一次写入或读取的状态）。
+    void set_style_watch_enabled(bool enabled);
+    bool is_style_watch_enabled() const;
+    void set_auto_reassert(bool enabled);
+    bool is_auto_reassert() const;
+    int poll_style_changes();
+
+    // 批量状态查询返回的状态位（opacity为两位的分类：不透明 / 半透明 / 完全透明）
+    enum WindowStateFlags {
+        STATE_VALID = 1 << 0,               // 成功读取了状态，否则其余位与句柄都为0
+        STATE_TASKBAR_HIDDEN = 1 << 1,
+        STATE_CLICK_THROUGH = 1 << 2,
+        STATE_LAYERED = 1 << 3,
+        STATE_OPACITY_TRANSLUCENT = 1 << 4, // 0 < 不透明度 < 1
+        STATE_OPACITY_TRANSPARENT = 2 << 4, // 不透明度为0
+        STATE_OPACITY_MASK = 3 << 4,
+    };
+
+    // 批量状态查询 - 一次调用、一次加锁读取所有窗口（windows为空时为所有受管理的窗口），
+    // 返回{"windows": Array, "handles": PackedInt64Array, "states": PackedByteArray}，三者按序号对应。
+    // 状态来自影子状态，只有第一次查询的窗口会读取系统；不经过异步队列，队列模式下未提交的变更不计入。
+    Dictionary query_window_states(const Array& windows = Array());
+
+    // 窗口ID - register_window登记一次后返回轻量的整数ID（同一Window重复登记返回同一ID），
+    // 样式、不透明度与渐变的*_id方法按ID取槽位，再按槽位中的窗口ID在句柄缓存中查一次记录，
+    // 省掉ObjectDB、Window::get_window_id与DisplayServer的跨边界调用；原生窗口重建后自动重新解析一次。
+    // 蒙版与悬停区域的耗时在图像/多边形处理上，对应的*_id方法取回Window对象后转发给Window版本。
+    // 行为与对应的Window方法相同（包括队列与异步模式）。Window离开场景树或unregister_window后ID失效，
+    // 槽位复用时代数不同，旧ID不会指向新窗口。query_window_states_by_id返回{"handles", "states"}。
+    int64_t register_window(Window* window);
+    bool unregister_window(int64_t id);
+    bool is_window_id_valid(int64_t id) const;
+    Window* get_window_by_id(int64_t id) const;
+    bool hide_id(int64_t id);
+    bool show_id(int64_t id);
+    bool is_visible_id(int64_t id);
+    bool set_clickable_id(int64_t id, bool clickable);
+    bool is_clickable_id(int64_t id);
+    bool set_opacity_id(int64_t id, float opacity);
+    float get_opacity_id(int64_t id);
+    bool fade_id(int64_t id, float opacity, float duration);
+    bool cancel_fade_id(int64_t id);
+    bool set_click_through_mask_id(int64_t id, const Ref<Image>& image, int threshold = 128, const Rect2i& dirty_rect = Rect2i());
+    bool set_click_through_polygon_id(int64_t id, const PackedVector2Array& polygon);
+    bool clear_click_through_mask_id(int64_t id);
+    bool set_hover_mask_id(int64_t id, const Ref<Image>& image, int threshold = 128);
+    bool set_hover_polygon_id(int64_t id, const PackedVector2Array& polygon);
+    bool clear_hover_id(int64_t id);
+    Dictionary query_window_states_by_id(const PackedInt64Array& ids);
+
     // 在类的公共方法部分添加
     int64_t get_window_system_handle(Window* window);
-    
-    // // 通过Window对象直接操作的方法
-    // bool hide_window_by_object(Window* window);
-    // bool show_window_by_object(Window* window);
-    // bool is_window_visible_by_object(Window* window);
-    
+
+    // 窗口句柄缓存（按窗口ID缓存原生句柄）
+    Dictionary get_handle_cache_stats() const;
+    void clear_handle_cache();
+
+    // 重新读取系统中的扩展样式（样式被外部修改后调用）
+    bool resync_window_styles(Window* window);
+    void resync_all_window_styles();
+
+    // 批量操作 - 每个窗口只提交一次，返回成功的窗口数量
+    int hide_many(const Array& windows);
+    int show_many(const Array& windows);
+    int set_clickable_many(const Array& windows, bool clickable);
+
+    // 队列模式 - hide/show/set_clickable只记录目标状态，每帧绘制前或调用commit时统一提交
+    void set_queued_mode(bool enabled);
+    bool is_queued_mode() const;
+    int commit();
+
+    // 异步模式 - 变更可在任意线程提交，由执行线程写入系统，调用线程不等待系统调用；
+    // 开启后hide/show/set_clickable及批量方法也走异步队列（返回true表示已提交）。
+    // 完成后在主线程发出operation_completed(request_id, ok)信号（每帧处理一次，也可调用poll_async_results）
+    void set_async_mode(bool enabled);
+    bool is_async_mode() const;
+    int64_t hide_async(Window* window);
+    int64_t show_async(Window* window);
+    int64_t set_clickable_async(Window* window, bool clickable);
+    int poll_async_results();
+
+    // 自动应用策略 - Window显示前按规则写入任务栏/穿透样式，不需要显示后再隐藏/显示一次
+    // match_by为"group"、"class"或"name"，pattern支持*和?通配符，先添加的规则优先；失败返回-1
+    int add_policy_rule(const String& match_by, const String& pattern, bool taskbar_visible, bool clickable);
+    void clear_policy_rules();
+    int get_policy_rule_count() const;
+    void set_policy_enabled(bool enabled);
+    bool is_policy_enabled() const;
+
+    // 样式配置 - 按节点路径保存受管理窗口当前的任务栏/穿透样式（运行时自动命名的窗口与池窗口不保存），
+    // 启动时load后，已经显示的窗口一次批量提交，之后加入场景树的窗口与自动应用策略一样在显示前写入（优先于规则），
+    // 不需要显示后再逐个hide/set_clickable。格式为带版本号的二进制，保存时保留配置中当前没有打开的窗口。
+    PackedByteArray save_style_profile();
+    bool load_style_profile(const PackedByteArray& data);
+    void clear_style_profile();
+    int get_style_profile_size() const;
+
+    // 窗口池 - 预先创建隐藏任务栏（默认同时鼠标穿透）的子窗口，取出/归还时不重建原生窗口。
+    // 池中的窗口保持显示并停放在屏幕外，取出后设置位置与大小即可使用，归还时重新停放并恢复池样式。
+    // 空闲窗口少于low_watermark时自动补充grow_by个（在下一次空闲时加入场景树）。需要关闭子窗口嵌入。
+    void configure_window_pool(int low_watermark, int grow_by, bool click_through = true);
+    int fill_window_pool(int count);
+    Window* acquire_pooled_window();
+    bool release_pooled_window(Window* window);
+    void clear_window_pool();
+    Dictionary get_window_pool_stats() const;
+
+    // 运行统计（进程级）：每种操作的调用次数、句柄缓存命中、重复请求与系统调用耗时
+    // 同样的数据在Godot调试器的监视器中显示（HideTaskbar分类）
+    Dictionary get_stats() const;
+    void reset_stats();
+
+    // 诊断事件 - 级别：0关闭，1错误，2警告，3信息，4调试（超过编译期上限的级别在编译时已移除）
+    // trace_level控制写入环形缓冲区的事件，trace_print_level控制同时输出到Godot的事件
+    void set_trace_level(int level);
+    int get_trace_level() const;
+    void set_trace_print_level(int level);
+    int get_trace_print_level() const;
+    String dump_trace() const;
+    PackedByteArray dump_trace_binary() const;
+    void clear_trace();
+
+    // 平台后端："default"、"null"、"fake"（内存中的伪后端，用于测试）
+    bool set_backend(const String& name);
+    String get_backend_name() const;
+
 private:
-#ifdef _WIN32
-    HWND get_window_handle(Window* window);
-    HWND get_main_window_handle();
-#endif
+    // 已连接失效信号的Window对象
+    struct WatchedWindow {
+        uint32_t window_id = 0;
+        Callable on_invalidated;
+        Callable on_tree_exiting;
+    };
+
+    // 自动应用策略的规则
+    enum PolicyMatch {
+        POLICY_MATCH_GROUP,
+        POLICY_MATCH_CLASS,
+        POLICY_MATCH_NAME,
+    };
+
+    struct PolicyRule {
+        PolicyMatch match_by = POLICY_MATCH_GROUP;
+        String pattern;
+        WindowStyleRequest request;
+    };
+
+    // 匹配到规则或样式配置的Window对象
+    struct PolicyWindow {
+        WindowStyleRequest request;
+        Callable on_visibility_changed;
+        Callable on_tree_exiting;
+    };
+
+    // 池窗口的状态：已创建但原生窗口尚未就绪 / 空闲 / 已取出
+    enum PoolState {
+        POOL_PENDING,
+        POOL_FREE,
+        POOL_IN_USE,
+    };
+
+    struct PoolWindow {
+        PoolState state = POOL_PENDING;
+        bool ready = false;
+        Callable on_ready;
+        Callable on_tree_exiting;
+    };
+
+    // 异步执行器与主线程共用manager，访问时持有manager_mutex（显示前钩子可能在持有时回调，因此为递归锁）
+    mutable std::recursive_mutex manager_mutex;
+    WindowStyleManager manager;
+    WindowExecutor executor{ manager, manager_mutex };
+    HoverTracker hover_tracker{ manager, manager_mutex };
+    Callable hover_poll_callable;
+    WindowFader fader{ manager, manager_mutex };
+    Callable fade_poll_callable;
+    std::unordered_map<uint64_t, WatchedWindow> watched_windows;
+
+    std::vector<PolicyRule> policy_rules;
+    std::unordered_map<uint64_t, PolicyWindow> policy_windows;
+    bool policy_enabled = false;
+    bool show_hooked = false;
+    Callable node_added_callable;
+
+    // 登记的窗口（按对象ID），槽位表由manager_mutex保护
+    struct RegisteredWindow {
+        int64_t id = 0;
+        Callable on_tree_exiting;
+    };
+    WindowSlotTable window_slots;
+    std::unordered_map<uint64_t, RegisteredWindow> registered_windows;
+
+    // 样式配置（按节点路径），只包含受管理的样式位
+    std::unordered_map<std::string, WindowStyleRequest> style_profile;
+
+    // 窗口池（按对象ID），空闲窗口按后进先出取出
+    std::unordered_map<uint64_t, PoolWindow> pool_windows;
+    std::vector<uint64_t> pool_free;
+    int pool_not_ready = 0; // 原生窗口尚未显示，显示前钩子需要保持安装
+    int pool_in_use = 0;
+    int pool_low_watermark = 0;
+    int pool_grow_by = 4;
+    bool pool_click_through = true;
+    uint64_t pool_hits = 0;
+    uint64_t pool_misses = 0;
+
+    // 每个Window对象（按对象ID）的点击区域蒙版
+    std::unordered_map<uint64_t, ClickMask> click_masks;
+
+    bool queued_mode = false;
+    bool flush_scheduled = false;
+    Callable flush_callable;
+
+    bool async_mode = false;
+    Callable async_poll_callable;
+
+    bool style_watch_enabled = false;
+    bool auto_reassert = false;
+    Callable style_watch_callable;
+    std::vector<NativeWindowHandle> style_changes;
+    std::vector<NativeWindowHandle> style_changes_deferred;
+
+    WindowRecord* get_window_record(Window* window);
+    void watch_window(Window* window, uint32_t window_id);
+    void unwatch_all_windows();
+    void _on_window_invalidated(uint64_t object_id);
+    void _on_window_tree_exiting(uint64_t object_id);
+
+    WindowRecord* get_slot_record(int64_t id);
+    Window* get_slot_window(int64_t id);
+    bool submit_slot_change(WindowRecord* record, const WindowStyleRequest& request);
+    uint8_t read_window_state(WindowRecord* record);
+    void unregister_all_windows();
+    void _on_registered_window_tree_exiting(uint64_t object_id);
+
+    bool submit_change(Window* window, const WindowStyleRequest& request);
+    bool submit_record(WindowRecord* record, const WindowStyleRequest& request);
+    int apply_many(const Array& windows, const WindowStyleRequest& request);
+    void schedule_flush();
+    void _on_frame_pre_draw();
+
+    uint64_t submit_async(Window* window, const WindowStyleRequest& request);
+    uint64_t submit_main_window_async(const WindowStyleRequest& request);
+    int submit_many_async(const Array& windows, const WindowStyleRequest& request);
+    void _on_async_process_frame();
+
+    void watch_record_styles(uint32_t window_id, uint64_t object_id, bool enabled);
+    void _on_style_watch_process_frame();
+
+    bool start_hover(Window* window, const std::vector<MaskRect>& rects, int32_t width, int32_t height, uint32_t& r_window_id);
+    void stop_hover();
+    void _on_hover_process_frame();
+
+    void start_fader();
+    void stop_fades();
+    void _on_fade_process_frame();
+
+    WindowRecord* get_main_window_record();
+    bool apply_click_mask(Window* window, WindowRecord* record, ClickMask& mask);
+
+    WindowStyleRequest get_pool_request() const;
+    Window* create_pool_window();
+    void park_pool_window(Window* window);
+    void refill_pool();
+    void _on_pool_window_ready(uint64_t object_id);
+    void _on_pool_window_tree_exiting(uint64_t object_id);
+    void update_show_hook();
+
+    int match_policy_rule(Window* window) const;
+    bool match_window_request(Window* window, WindowStyleRequest& r_request) const;
+    bool watch_policy_window(Window* window, WindowStyleRequest& r_request);
+    void update_policy_watch();
+    void scan_policy_windows();
+    void unwatch_policy_windows();
+    void _on_node_added(Node* node);
+    void _on_policy_window_visibility_changed(uint64_t object_id);
+    void _on_policy_window_tree_exiting(uint64_t object_id);
+    static bool policy_show_hook(NativeWindowHandle handle, uint32_t current_style, uint32_t& r_style, void* userdata);
 };
 
-#endif // HIDE_TASKBAR_EXTENSION_H
\ No newline at end of file
+#endif // HIDE_TASKBAR_EXTENSION_H
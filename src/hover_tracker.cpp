@@ -0,0 +1,248 @@
+#include "hover_tracker.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+
+// 命中区域位集
+void HoverRegion::build(const MaskRect* rects, size_t count, int32_t p_width, int32_t p_height) {
+    width = std::max(0, p_width);
+    height = std::max(0, p_height);
+    words_per_row = (size_t)(width + 63) >> 6;
+    bits.assign(words_per_row * height, 0);
+
+    for (size_t i = 0; i < count; i++) {
+        int32_t x0 = std::max(0, rects[i].x);
+        int32_t y0 = std::max(0, rects[i].y);
+        int32_t x1 = std::min(width, rects[i].x + rects[i].width);
+        int32_t y1 = std::min(height, rects[i].y + rects[i].height);
+        if (x0 >= x1 || y0 >= y1) {
+            continue;
+        }
+
+        // 按整字置位：首尾字用掩码，中间的字整字填满
+        size_t first = (size_t)x0 >> 6;
+        size_t last = (size_t)(x1 - 1) >> 6;
+        uint64_t first_mask = ~0ull << (x0 & 63);
+        uint64_t last_mask = ~0ull >> (63 - ((x1 - 1) & 63));
+        for (int32_t y = y0; y < y1; y++) {
+            uint64_t* row = bits.data() + words_per_row * y;
+            if (first == last) {
+                row[first] |= first_mask & last_mask;
+                continue;
+            }
+            row[first] |= first_mask;
+            for (size_t w = first + 1; w < last; w++) {
+                row[w] = ~0ull;
+            }
+            row[last] |= last_mask;
+        }
+    }
+}
+
+bool HoverRegion::contains(int32_t x, int32_t y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return false;
+    }
+    return (bits[words_per_row * y + ((size_t)x >> 6)] >> (x & 63)) & 1;
+}
+
+// 悬停跟踪
+HoverTracker::HoverTracker(WindowStyleManager& p_manager, std::recursive_mutex& p_manager_mutex) :
+        manager(p_manager), manager_mutex(p_manager_mutex) {
+}
+
+HoverTracker::~HoverTracker() {
+    stop();
+}
+
+void HoverTracker::set_window(uint32_t window_id, uint64_t owner_id, std::shared_ptr<const HoverRegion> region) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    for (TrackedWindow& window : windows) {
+        if (window.owner_id == owner_id) {
+            window.window_id = window_id;
+            window.region = region;
+            window.hovered = -1;
+            window.generation = next_generation++;
+            return;
+        }
+    }
+
+    TrackedWindow window;
+    window.window_id = window_id;
+    window.owner_id = owner_id;
+    window.region = region;
+    window.generation = next_generation++;
+    windows.push_back(window);
+}
+
+bool HoverTracker::remove_window(uint64_t owner_id) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    for (size_t i = 0; i < windows.size(); i++) {
+        if (windows[i].owner_id == owner_id) {
+            windows[i] = windows.back();
+            windows.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void HoverTracker::invalidate(uint64_t owner_id) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    for (TrackedWindow& window : windows) {
+        if (window.owner_id == owner_id) {
+            window.hovered = -1;
+            window.generation = next_generation++;
+        }
+    }
+}
+
+void HoverTracker::clear() {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    windows.clear();
+}
+
+size_t HoverTracker::get_window_count() const {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    return windows.size();
+}
+
+void HoverTracker::set_interval_ms(int p_interval_ms) {
+    interval_ms = std::max(1, p_interval_ms);
+    wake.notify_one();
+}
+
+void HoverTracker::start() {
+    if (thread.joinable()) {
+        return;
+    }
+    stopping = false;
+    finished = false;
+    thread = std::thread(&HoverTracker::run, this);
+}
+
+void HoverTracker::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+
+    // 与异步执行器相同：Win32下跟踪线程写入样式时会同步等待窗口线程
+    while (!finished.load()) {
+        manager.get_backend()->process_pending_messages();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    thread.join();
+}
+
+bool HoverTracker::poll_event(HoverEvent& r_event) {
+    return events.pop(r_event);
+}
+
+void HoverTracker::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait_for(lock, std::chrono::milliseconds(interval_ms.load()), [this]() { return stopping.load(); });
+        }
+        if (stopping.load()) {
+            break;
+        }
+        tick();
+    }
+    finished = true;
+}
+
+int HoverTracker::tick() {
+    WindowBackend* backend = nullptr;
+    {
+        // 解析句柄（命中缓存时不访问系统）并复制窗口列表
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        samples.clear();
+        for (const TrackedWindow& window : windows) {
+            WindowRecord* record = manager.resolve(window.window_id, window.owner_id);
+            if (!record) {
+                continue;
+            }
+            Sample sample;
+            sample.window_id = window.window_id;
+            sample.owner_id = window.owner_id;
+            sample.generation = window.generation;
+            sample.handle = record->handle;
+            sample.region = window.region;
+            sample.hovered = window.hovered;
+            samples.push_back(sample);
+        }
+        backend = manager.get_backend();
+    }
+
+    // 读取光标与查位集都不持有锁
+    changed.clear();
+    for (size_t i = 0; i < samples.size(); i++) {
+        Sample& sample = samples[i];
+        int32_t x = 0;
+        int32_t y = 0;
+        int hovered = backend->get_cursor_position(sample.handle, x, y) && sample.region->contains(x, y) ? 1 : 0;
+        if (hovered != sample.hovered) {
+            sample.hovered = hovered;
+            changed.push_back(i);
+        }
+    }
+    if (changed.empty()) {
+        return 0;
+    }
+
+    slots.clear();
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        batch.clear();
+        for (size_t index : changed) {
+            const Sample& sample = samples[index];
+            // 悬停切换只改TRANSPARENT，分层样式保持不变，避免反复重建分层窗口
+            WindowStyleRequest request;
+            request.set_clickable = true;
+            request.clickable = sample.hovered == 1;
+            request.keep_layered = true;
+            WindowRecord* record = manager.find(sample.window_id, sample.owner_id);
+            slots.push_back(record && record->handle == sample.handle ? batch.add(record, request) : WindowStyleBatch::INVALID_INDEX);
+        }
+        manager.prepare(batch.get_records(), batch.get_requests(), batch.size(), plan);
+    }
+
+    // 系统调用期间不持有锁
+    WindowStyleManager::submit(backend, plan);
+
+    int count = 0;
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    manager.finish(plan);
+    for (size_t i = 0; i < changed.size(); i++) {
+        const Sample& sample = samples[changed[i]];
+        // 检查期间窗口被移除或换了区域时丢弃结果
+        auto it = std::find_if(windows.begin(), windows.end(), [&](const TrackedWindow& window) {
+            return window.owner_id == sample.owner_id && window.generation == sample.generation;
+        });
+        if (it == windows.end()) {
+            continue;
+        }
+
+        // 写入失败时也记下状态，避免每次检查都重试并刷出警告；下一次变化时再写入
+        it->hovered = sample.hovered;
+        HoverEvent event;
+        event.window_id = sample.window_id;
+        event.owner_id = sample.owner_id;
+        event.hovered = sample.hovered == 1;
+        event.ok = slots[i] != WindowStyleBatch::INVALID_INDEX && plan.ok[slots[i]];
+        if (!event.ok) {
+            HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_HOVER, sample.window_id, false, "Failed to apply hover click-through");
+        }
+        events.push(event);
+        count++;
+    }
+    return count;
+}
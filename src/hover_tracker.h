@@ -0,0 +1,119 @@
+#ifndef HOVER_TRACKER_H
+#define HOVER_TRACKER_H
+
+#include "click_mask.h"
+#include "mpsc_queue.h"
+#include "window_style_manager.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 命中区域位集：每像素1位，按行存放，查询一个点只需一次移位
+class HoverRegion {
+public:
+    // 由点击区域矩形生成（矩形超出width/height的部分被裁掉）
+    void build(const MaskRect* rects, size_t count, int32_t width, int32_t height);
+    bool contains(int32_t x, int32_t y) const;
+
+    int32_t get_width() const { return width; }
+    int32_t get_height() const { return height; }
+
+private:
+    int32_t width = 0;
+    int32_t height = 0;
+    size_t words_per_row = 0;
+    std::vector<uint64_t> bits;
+};
+
+// 悬停状态变化，ok表示穿透样式已经写入
+struct HoverEvent {
+    uint32_t window_id = 0;
+    uint64_t owner_id = 0;
+    bool hovered = false;
+    bool ok = false;
+};
+
+// 悬停穿透：专用线程按固定间隔读取光标位置，与每个窗口的命中区域位集比较。
+// 光标在区域内时窗口可点击，否则鼠标穿透；只在悬停状态变化时写入样式（同一次检查中变化的窗口合并为一批），
+// 变化放入无锁队列，由主线程取回后发出信号。
+// 与异步执行器一样，只在解析句柄和写回影子状态时持有manager_mutex，读取光标与调用后端时不持有。
+class HoverTracker {
+public:
+    static const int DEFAULT_INTERVAL_MS = 33;
+
+    HoverTracker(WindowStyleManager& p_manager, std::recursive_mutex& p_manager_mutex);
+    ~HoverTracker();
+
+    // 添加或替换窗口的命中区域，下一次检查一定写入一次当前状态
+    void set_window(uint32_t window_id, uint64_t owner_id, std::shared_ptr<const HoverRegion> region);
+    bool remove_window(uint64_t owner_id);
+    // 原生窗口重建后调用，下一次检查重新写入当前状态
+    void invalidate(uint64_t owner_id);
+    void clear();
+    size_t get_window_count() const;
+
+    void set_interval_ms(int interval_ms);
+    int get_interval_ms() const { return interval_ms.load(); }
+
+    // 有窗口时才需要启动；stop在主线程调用
+    void start();
+    void stop();
+    bool is_running() const { return thread.joinable(); }
+
+    // 检查一次所有窗口（跟踪线程调用，也可以在测试中直接调用），返回状态变化的窗口数
+    int tick();
+
+    // 取回一条变化，只能在一个线程（主线程）调用
+    bool poll_event(HoverEvent& r_event);
+
+private:
+    struct TrackedWindow {
+        uint32_t window_id = 0;
+        uint64_t owner_id = 0;
+        std::shared_ptr<const HoverRegion> region;
+        int hovered = -1; // -1为尚未写入
+        uint64_t generation = 0;
+    };
+
+    // 一次检查中的窗口快照，检查期间主线程可以修改窗口列表
+    struct Sample {
+        uint32_t window_id = 0;
+        uint64_t owner_id = 0;
+        uint64_t generation = 0;
+        NativeWindowHandle handle = 0;
+        std::shared_ptr<const HoverRegion> region;
+        int hovered = -1;
+    };
+
+    void run();
+
+    WindowStyleManager& manager;
+    std::recursive_mutex& manager_mutex;
+
+    // 窗口列表由manager_mutex保护
+    std::vector<TrackedWindow> windows;
+    uint64_t next_generation = 1;
+
+    MpscQueue<HoverEvent> events;
+    std::atomic<int> interval_ms{ DEFAULT_INTERVAL_MS };
+
+    std::thread thread;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{ false };
+    std::atomic<bool> finished{ false };
+
+    // 跟踪线程复用的缓冲区
+    std::vector<Sample> samples;
+    std::vector<size_t> changed;
+    std::vector<size_t> slots;
+    WindowStyleBatch batch;
+    WindowStylePlan plan;
+};
+
+#endif // HOVER_TRACKER_H
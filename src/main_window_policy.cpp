@@ -0,0 +1,110 @@
+#include "main_window_policy.h"
+#include "trace.h"
+#include "window_style_manager.h"
+#include <godot_cpp/classes/display_server.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace godot;
+
+static const char* SETTING_HIDE_FROM_TASKBAR = "hide_taskbar/main_window/hide_from_taskbar";
+static const char* SETTING_CLICK_THROUGH = "hide_taskbar/main_window/click_through";
+
+// 启动期间使用的独立后端，SCENE级别初始化结束后释放
+static std::unique_ptr<WindowStyleManager> startup_manager;
+static WindowStyleRequest startup_request;
+static bool startup_applied = false;
+
+static void add_bool_setting(ProjectSettings* settings, const char* name) {
+    if (!settings->has_setting(name)) {
+        settings->set_setting(name, false);
+    }
+    settings->set_initial_value(name, false);
+
+    Dictionary info;
+    info["name"] = name;
+    info["type"] = Variant::BOOL;
+    settings->add_property_info(info);
+}
+
+static NativeWindowHandle startup_lookup(uint32_t window_id, void* userdata) {
+    DisplayServer* display_server = DisplayServer::get_singleton();
+    if (!display_server) {
+        return 0;
+    }
+    return display_server->window_get_native_handle(DisplayServer::HandleType::WINDOW_HANDLE, window_id);
+}
+
+static bool startup_show_hook(NativeWindowHandle handle, uint32_t current_style, uint32_t& r_style, void* userdata) {
+    // 主线程上第一个显示的顶级窗口就是主窗口（启动画面也画在它上面）
+    if (startup_applied) {
+        return false;
+    }
+    startup_applied = true;
+    r_style = WindowStyleManager::compute_target_style(current_style, startup_request);
+    return true;
+}
+
+void register_main_window_settings() {
+    ProjectSettings* settings = ProjectSettings::get_singleton();
+    if (!settings) {
+        return;
+    }
+    add_bool_setting(settings, SETTING_HIDE_FROM_TASKBAR);
+    add_bool_setting(settings, SETTING_CLICK_THROUGH);
+}
+
+void begin_main_window_policy() {
+    ProjectSettings* settings = ProjectSettings::get_singleton();
+    Engine* engine = Engine::get_singleton();
+    // 编辑器里不隐藏编辑器自己的窗口
+    if (!settings || !engine || engine->is_editor_hint()) {
+        return;
+    }
+
+    bool hide_from_taskbar = settings->get_setting(SETTING_HIDE_FROM_TASKBAR, false);
+    bool click_through = settings->get_setting(SETTING_CLICK_THROUGH, false);
+    if (!hide_from_taskbar && !click_through) {
+        return;
+    }
+
+    startup_request = WindowStyleRequest();
+    if (hide_from_taskbar) {
+        startup_request.set_taskbar = true;
+        startup_request.taskbar_visible = false;
+    }
+    if (click_through) {
+        startup_request.set_clickable = true;
+        startup_request.clickable = false;
+    }
+
+    startup_applied = false;
+    startup_manager.reset(new WindowStyleManager());
+    startup_manager->set_handle_lookup(startup_lookup, nullptr);
+    startup_manager->get_backend()->set_show_hook(startup_show_hook, nullptr);
+}
+
+void end_main_window_policy() {
+    if (!startup_manager) {
+        return;
+    }
+
+    startup_manager->get_backend()->set_show_hook(nullptr, nullptr);
+
+    // X11后端只能处理X11 DisplayServer返回的句柄
+    DisplayServer* display_server = DisplayServer::get_singleton();
+    bool usable = display_server && (std::string(startup_manager->get_backend()->get_name()) != "x11" || display_server->get_name() == "X11");
+
+    if (!startup_applied && usable) {
+        // 钩子没有生效（平台不支持或主窗口已经显示），直接应用
+        WindowRecord* record = startup_manager->resolve(WindowStyleManager::MAIN_WINDOW_ID, 0);
+        if (!record || startup_manager->apply(&record, &startup_request, 1) != 1) {
+            HIDE_TASKBAR_TRACE(TRACE_LEVEL_ERROR, TRACE_OP_STARTUP, WindowStyleManager::MAIN_WINDOW_ID, false, "Failed to apply main window project settings");
+        }
+    }
+    startup_manager.reset();
+}
@@ -0,0 +1,18 @@
+#ifndef MAIN_WINDOW_POLICY_H
+#define MAIN_WINDOW_POLICY_H
+
+// 项目设置中的主窗口策略
+// hide_taskbar/main_window/hide_from_taskbar：启动时不在任务栏显示主窗口
+// hide_taskbar/main_window/click_through：启动时主窗口鼠标穿透
+//
+// 扩展在SERVERS级别初始化时DisplayServer还没有创建主窗口，此时安装显示前钩子，
+// 主窗口第一次显示前就写入样式；不支持钩子的平台在SCENE级别初始化时直接应用。
+
+// 注册项目设置（SERVERS级别）
+void register_main_window_settings();
+// 读取设置并安装显示前钩子（SERVERS级别，在register_main_window_settings之后）
+void begin_main_window_policy();
+// 卸载钩子，钩子没有生效时直接应用（SCENE级别）
+void end_main_window_policy();
+
+#endif // MAIN_WINDOW_POLICY_H
@@ -0,0 +1,87 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+
+// 多生产者单消费者无锁队列（Vyukov的侵入式MPSC队列）
+// push可在任意线程调用，只有一次原子交换；pop只能由一个线程调用。
+// 生产者交换头指针后、链接next之前被挂起时，pop暂时返回false，稍后再取即可。
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() :
+            head(&stub), tail(&stub) {
+        stub.next.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(const T& value) {
+        Node* node = new Node();
+        node->value = value;
+        push_node(node);
+    }
+
+    bool pop(T& r_value) {
+        Node* node = tail;
+        Node* next = node->next.load(std::memory_order_acquire);
+
+        // 跳过占位节点
+        if (node == &stub) {
+            if (!next) {
+                return false;
+            }
+            tail = next;
+            node = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            tail = next;
+            r_value = node->value;
+            delete node;
+            return true;
+        }
+
+        // 生产者正在链接新节点
+        if (node != head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        // 队列只剩最后一个节点，重新放入占位节点后才能取出它
+        push_node(&stub);
+        next = node->next.load(std::memory_order_acquire);
+        if (next) {
+            tail = next;
+            r_value = node->value;
+            delete node;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{ nullptr };
+        T value;
+    };
+
+    void push_node(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    std::atomic<Node*> head;
+    Node* tail;
+    Node stub;
+};
+
+#endif // MPSC_QUEUE_H
@@ -0,0 +1,150 @@
+#include "op_stats.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static std::atomic<uint64_t> stats_calls[OP_STATS_MAX_OPS] = {};
+static std::atomic<uint64_t> stats_redundant{ 0 };
+static std::atomic<uint64_t> stats_cache_hits{ 0 };
+static std::atomic<uint64_t> stats_cache_misses{ 0 };
+static std::atomic<uint64_t> stats_native_windows{ 0 };
+static LatencyHistogram stats_native_latency;
+
+static int highest_bit(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+static void atomic_store_max(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+// 直方图
+// 小于4的值各占一个桶；其余值按最高位所在的2的幂区间分组，再按接下来的两位分为4个子桶。
+int LatencyHistogram::bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return (int)value;
+    }
+    int bit = highest_bit(value);
+    int sub = (int)((value >> (bit - 2)) & (SUB_BUCKETS - 1));
+    return (bit - 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucket_lower_bound(int index) {
+    if (index < SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+    int bit = index / SUB_BUCKETS + 1;
+    uint64_t sub = (uint64_t)(index % SUB_BUCKETS);
+    return (1ull << bit) | (sub << (bit - 2));
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    atomic_store_max(max, value);
+    atomic_store_max(recent_max, value);
+}
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+    count = 0;
+    max = 0;
+    recent_max = 0;
+}
+
+uint64_t LatencyHistogram::get_percentile(double percentile) const {
+    uint64_t total = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        total += buckets[i].load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // 第rank个样本（从1开始）所在的桶
+    uint64_t rank = (uint64_t)(percentile * (double)total);
+    if (rank < 1) {
+        rank = 1;
+    } else if (rank > total) {
+        rank = total;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t lower = bucket_lower_bound(i);
+            uint64_t upper = i + 1 < BUCKET_COUNT ? bucket_lower_bound(i + 1) : lower;
+            uint64_t middle = lower + (upper - lower) / 2;
+            // 桶的中点可能超过实际最大值
+            uint64_t maximum = max.load(std::memory_order_relaxed);
+            return middle < maximum ? middle : maximum;
+        }
+    }
+    return max.load(std::memory_order_relaxed);
+}
+
+// 全局统计
+void stats_record_call(int op) {
+    if (op >= 0 && op < OP_STATS_MAX_OPS) {
+        stats_calls[op].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void stats_record_redundant() {
+    stats_redundant.fetch_add(1, std::memory_order_relaxed);
+}
+
+void stats_record_lookup(bool cache_hit) {
+    (cache_hit ? stats_cache_hits : stats_cache_misses).fetch_add(1, std::memory_order_relaxed);
+}
+
+void stats_record_native_change(uint64_t duration_ns, size_t windows) {
+    stats_native_latency.record(duration_ns);
+    stats_native_windows.fetch_add(windows, std::memory_order_relaxed);
+}
+
+uint64_t stats_get_calls(int op) {
+    return op >= 0 && op < OP_STATS_MAX_OPS ? stats_calls[op].load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t stats_get_redundant() {
+    return stats_redundant.load(std::memory_order_relaxed);
+}
+
+uint64_t stats_get_cache_hits() {
+    return stats_cache_hits.load(std::memory_order_relaxed);
+}
+
+uint64_t stats_get_cache_misses() {
+    return stats_cache_misses.load(std::memory_order_relaxed);
+}
+
+uint64_t stats_get_native_windows() {
+    return stats_native_windows.load(std::memory_order_relaxed);
+}
+
+LatencyHistogram& stats_get_native_latency() {
+    return stats_native_latency;
+}
+
+void stats_reset() {
+    for (int i = 0; i < OP_STATS_MAX_OPS; i++) {
+        stats_calls[i].store(0, std::memory_order_relaxed);
+    }
+    stats_redundant = 0;
+    stats_cache_hits = 0;
+    stats_cache_misses = 0;
+    stats_native_windows = 0;
+    stats_native_latency.reset();
+}
@@ -0,0 +1,57 @@
+#ifndef OP_STATS_H
+#define OP_STATS_H
+
+// 进程级的运行统计：每种操作的调用次数、句柄缓存命中、重复请求与系统调用耗时
+// 只用宽松的原子计数，任何线程都可以记录；不依赖Godot（Godot中作为Performance自定义监视器显示）。
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 操作编号与TraceOp一致
+static const int OP_STATS_MAX_OPS = 32;
+
+// 对数分桶的延迟直方图：每个2的幂区间分为4个子桶，相对误差不超过12.5%，记录一次只需两次原子加
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKETS = 4;
+    // 0~3各占一个桶，最高位在第2~63位的值每个区间4个子桶，共252个
+    static const int BUCKET_COUNT = 63 * SUB_BUCKETS;
+
+    void record(uint64_t value);
+    void reset();
+
+    uint64_t get_count() const { return count.load(std::memory_order_relaxed); }
+    uint64_t get_max() const { return max.load(std::memory_order_relaxed); }
+    // 取出并清零上次读取以来的最大值（监视器每帧采样时用于定位卡顿）
+    uint64_t take_recent_max() { return recent_max.exchange(0, std::memory_order_relaxed); }
+    // percentile为0~1，返回所在桶的中点
+    uint64_t get_percentile(double percentile) const;
+
+    static int bucket_index(uint64_t value);
+    static uint64_t bucket_lower_bound(int index);
+
+private:
+    std::atomic<uint64_t> buckets[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<uint64_t> max{ 0 };
+    std::atomic<uint64_t> recent_max{ 0 };
+};
+
+void stats_record_call(int op);
+// 目标状态已经生效，没有访问系统
+void stats_record_redundant();
+void stats_record_lookup(bool cache_hit);
+// 一次后端提交（一批窗口）的耗时
+void stats_record_native_change(uint64_t duration_ns, size_t windows);
+
+uint64_t stats_get_calls(int op);
+uint64_t stats_get_redundant();
+uint64_t stats_get_cache_hits();
+uint64_t stats_get_cache_misses();
+uint64_t stats_get_native_windows();
+LatencyHistogram& stats_get_native_latency();
+
+void stats_reset();
+
+#endif // OP_STATS_H
@@ -1,23 +1,152 @@
 #include "hide_taskbar_extension.h"
+#include "main_window_policy.h"
+#include "op_stats.h"
+#include "trace.h"
 #include <gdextension_interface.h>
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/godot.hpp>
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <vector>
 
 using namespace godot;
 
+// 达到输出级别的诊断事件写入Godot输出（可能在执行线程上调用，print本身是线程安全的）
+static void print_trace_event(const TraceEvent& event) {
+    String line = String::utf8(trace_format_event(event).c_str());
+    if (event.level == TRACE_LEVEL_ERROR) {
+        UtilityFunctions::printerr(line);
+    } else {
+        UtilityFunctions::print(line);
+    }
+}
+
+// Performance自定义监视器（调试器的监视器页面中的HideTaskbar分类）
+// 调用次数与命中数为累计值，frame_max_us为两次采样之间（约一帧）最慢的一次系统调用。
+static std::vector<StringName> registered_monitors;
+
+static int64_t monitor_calls(int op) {
+    return (int64_t)stats_get_calls(op);
+}
+
+static int64_t monitor_handle_lookups() {
+    return (int64_t)stats_get_cache_misses();
+}
+
+static double monitor_cache_hit_ratio() {
+    uint64_t hits = stats_get_cache_hits();
+    uint64_t total = hits + stats_get_cache_misses();
+    return total > 0 ? 100.0 * hits / total : 0.0;
+}
+
+static int64_t monitor_redundant_calls() {
+    return (int64_t)stats_get_redundant();
+}
+
+static int64_t monitor_native_changes() {
+    return (int64_t)stats_get_native_latency().get_count();
+}
+
+static double monitor_native_p50() {
+    return stats_get_native_latency().get_percentile(0.5) / 1000.0;
+}
+
+static double monitor_native_p99() {
+    return stats_get_native_latency().get_percentile(0.99) / 1000.0;
+}
+
+static double monitor_native_max() {
+    return stats_get_native_latency().get_max() / 1000.0;
+}
+
+static double monitor_native_frame_max() {
+    return stats_get_native_latency().take_recent_max() / 1000.0;
+}
+
+static void add_monitor(Performance* performance, const String& name, const Callable& callable, const Array& arguments = Array()) {
+    StringName id = "HideTaskbar/" + name;
+    if (performance->has_custom_monitor(id)) {
+        performance->remove_custom_monitor(id);
+    }
+    performance->add_custom_monitor(id, callable, arguments);
+    registered_monitors.push_back(id);
+}
+
+static void register_monitors() {
+    Performance* performance = Performance::get_singleton();
+    if (!performance) {
+        return;
+    }
+
+    const TraceOp ops[] = {
+        TRACE_OP_HIDE,
+        TRACE_OP_SHOW,
+        TRACE_OP_IS_VISIBLE,
+        TRACE_OP_SET_CLICKABLE,
+        TRACE_OP_IS_CLICKABLE,
+        TRACE_OP_CLICK_MASK,
+        TRACE_OP_GET_HANDLE,
+        TRACE_OP_ASYNC,
+        TRACE_OP_HOVER,
+        TRACE_OP_OPACITY,
+        TRACE_OP_QUERY,
+    };
+    for (TraceOp op : ops) {
+        Array arguments;
+        arguments.push_back((int)op);
+        add_monitor(performance, String("calls_") + trace_op_name(op), callable_mp_static(&monitor_calls), arguments);
+    }
+
+    add_monitor(performance, "handle_lookups", callable_mp_static(&monitor_handle_lookups));
+    add_monitor(performance, "cache_hit_ratio", callable_mp_static(&monitor_cache_hit_ratio));
+    add_monitor(performance, "redundant_calls", callable_mp_static(&monitor_redundant_calls));
+    add_monitor(performance, "native_changes", callable_mp_static(&monitor_native_changes));
+    add_monitor(performance, "native_p50_us", callable_mp_static(&monitor_native_p50));
+    add_monitor(performance, "native_p99_us", callable_mp_static(&monitor_native_p99));
+    add_monitor(performance, "native_max_us", callable_mp_static(&monitor_native_max));
+    add_monitor(performance, "native_frame_max_us", callable_mp_static(&monitor_native_frame_max));
+}
+
+static void unregister_monitors() {
+    Performance* performance = Performance::get_singleton();
+    if (performance) {
+        for (const StringName& id : registered_monitors) {
+            if (performance->has_custom_monitor(id)) {
+                performance->remove_custom_monitor(id);
+            }
+        }
+    }
+    registered_monitors.clear();
+}
+
 void initialize_hide_taskbar_module(ModuleInitializationLevel p_level) {
+    if (p_level == MODULE_INITIALIZATION_LEVEL_SERVERS) {
+        trace_set_sink(print_trace_event);
+
+        // 此时主窗口还没有创建，提前安装主窗口策略
+        register_main_window_settings();
+        begin_main_window_policy();
+        return;
+    }
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
 
+    end_main_window_policy();
+
     // 注册全局类
     ClassDB::register_class<HideTaskBarInWindowsSystem>();
+    register_monitors();
 }
 
 void uninitialize_hide_taskbar_module(ModuleInitializationLevel p_level) {
-    if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
-        return;
+    if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
+        unregister_monitors();
+    } else if (p_level == MODULE_INITIALIZATION_LEVEL_SERVERS) {
+        trace_set_sink(nullptr);
     }
 }
 
@@ -27,8 +156,8 @@ extern "C" {
 
         init_obj.register_initializer(initialize_hide_taskbar_module);
         init_obj.register_terminator(uninitialize_hide_taskbar_module);
-        init_obj.set_minimum_library_initialization_level(MODULE_INITIALIZATION_LEVEL_SCENE);
+        init_obj.set_minimum_library_initialization_level(MODULE_INITIALIZATION_LEVEL_SERVERS);
 
         return init_obj.init();
     }
-}
\ No newline at end of file
+}
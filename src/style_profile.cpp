@@ -0,0 +1,97 @@
+#include "style_profile.h"
+
+#include <cstring>
+
+static const uint8_t STYLE_PROFILE_MAGIC[4] = { 'H', 'T', 'S', 'P' };
+
+static void put_u16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t value) {
+    put_u16(p, (uint16_t)value);
+    put_u16(p + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+uint8_t StyleProfile::pack(const WindowStyleRequest& request) {
+    return (uint8_t)((request.restore_style & STYLE_MASK) | ((request.restore_mask & STYLE_MASK) << 4));
+}
+
+WindowStyleRequest StyleProfile::unpack(uint8_t packed) {
+    WindowStyleRequest request;
+    request.restore = true;
+    request.restore_style = packed & STYLE_MASK;
+    request.restore_mask = (packed >> 4) & STYLE_MASK;
+    return request;
+}
+
+size_t StyleProfile::get_size(const std::map<std::string, uint8_t>& entries) {
+    size_t size = HEADER_SIZE;
+    for (const auto& entry : entries) {
+        if (entry.first.size() <= 0xFFFF) {
+            size += 3 + entry.first.size();
+        }
+    }
+    return size;
+}
+
+void StyleProfile::write(const std::map<std::string, uint8_t>& entries, uint8_t* r_data) {
+    uint32_t count = 0;
+    uint8_t* w = r_data + HEADER_SIZE;
+    for (const auto& entry : entries) {
+        if (entry.first.size() > 0xFFFF) {
+            continue;
+        }
+        put_u16(w, (uint16_t)entry.first.size());
+        memcpy(w + 2, entry.first.data(), entry.first.size());
+        w += 2 + entry.first.size();
+        *w++ = entry.second;
+        count++;
+    }
+
+    memcpy(r_data, STYLE_PROFILE_MAGIC, 4);
+    put_u16(r_data + 4, VERSION);
+    put_u16(r_data + 6, 0);
+    put_u32(r_data + 8, count);
+}
+
+StyleProfile::Result StyleProfile::parse(const uint8_t* data, size_t size, std::unordered_map<std::string, WindowStyleRequest>& r_entries) {
+    if (size < HEADER_SIZE || memcmp(data, STYLE_PROFILE_MAGIC, 4) != 0) {
+        return INVALID;
+    }
+    if (get_u16(data + 4) > VERSION) {
+        return UNSUPPORTED_VERSION;
+    }
+
+    // 条目数来自数据本身，不用于预先分配
+    std::unordered_map<std::string, WindowStyleRequest> loaded;
+    uint32_t count = get_u32(data + 8);
+    size_t offset = HEADER_SIZE;
+    for (uint32_t i = 0; i < count; i++) {
+        if (size - offset < 2) {
+            return TRUNCATED;
+        }
+        size_t length = get_u16(data + offset);
+        if (size - offset - 2 < length + 1) {
+            return TRUNCATED;
+        }
+        std::string path((const char*)data + offset + 2, length);
+        loaded[path] = unpack(data[offset + 2 + length]);
+        offset += 3 + length;
+    }
+    if (offset != size) {
+        return INVALID;
+    }
+
+    r_entries.swap(loaded);
+    return OK;
+}
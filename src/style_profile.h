@@ -0,0 +1,41 @@
+#ifndef STYLE_PROFILE_H
+#define STYLE_PROFILE_H
+
+#include "window_style_manager.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+// 样式配置的二进制格式（小端）："HTSP"、uint16版本、uint16保留、uint32条目数，
+// 之后每个条目为uint16路径长度、UTF-8节点路径、1字节样式（低4位为受管理的样式位，高4位为这些位的掩码）。
+// 条目按路径排序写入，相同状态保存的结果相同。不依赖Godot，前端负责与PackedByteArray互相转换。
+class StyleProfile {
+public:
+    enum Result {
+        OK,
+        INVALID,              // 头部过短、标识不符或条目之后还有多余数据
+        UNSUPPORTED_VERSION,  // 由更新的版本保存
+        TRUNCATED,            // 条目不完整
+    };
+
+    static const uint16_t VERSION = 1;
+    static const size_t HEADER_SIZE = 12;
+    static const uint32_t STYLE_MASK = WINDOW_STYLE_TASKBAR_MASK | WINDOW_STYLE_CLICK_THROUGH_MASK;
+
+    // 样式请求与1字节打包值互相转换，解包得到的请求为restore请求
+    static uint8_t pack(const WindowStyleRequest& request);
+    static WindowStyleRequest unpack(uint8_t packed);
+
+    // 路径超过65535字节的条目不写入
+    static size_t get_size(const std::map<std::string, uint8_t>& entries);
+    // r_data需要get_size(entries)字节
+    static void write(const std::map<std::string, uint8_t>& entries, uint8_t* r_data);
+
+    // 全部解析成功时才写入r_entries（替换原有内容），失败时r_entries不变
+    static Result parse(const uint8_t* data, size_t size, std::unordered_map<std::string, WindowStyleRequest>& r_entries);
+};
+
+#endif // STYLE_PROFILE_H
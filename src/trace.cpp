@@ -0,0 +1,238 @@
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// 每个槽位以序号保护（seqlock）：写入前置为奇数，写完置为偶数，读取时序号前后一致才有效。
+// 写入只需要一次fetch_add取得槽位，多个线程同时记录也不会互相等待。
+struct TraceSlot {
+    std::atomic<uint64_t> sequence{ 0 };
+    std::atomic<uint64_t> words[4];
+};
+
+static const uint64_t TRACE_MASK = TRACE_CAPACITY - 1;
+static_assert((TRACE_CAPACITY & TRACE_MASK) == 0, "TRACE_CAPACITY must be a power of two");
+
+static TraceSlot trace_slots[TRACE_CAPACITY];
+static std::atomic<uint64_t> trace_write_index{ 0 };
+static std::atomic<uint64_t> trace_clear_index{ 0 };
+static std::atomic<int> trace_level{ TRACE_LEVEL_INFO };
+static std::atomic<int> trace_print_level{ TRACE_LEVEL_WARNING };
+static std::atomic<TraceSink> trace_sink{ nullptr };
+
+static const char* TRACE_OP_NAMES[TRACE_OP_COUNT] = {
+    "lifecycle",
+    "backend",
+    "resolve",
+    "hide",
+    "show",
+    "is_visible",
+    "set_clickable",
+    "is_clickable",
+    "click_mask",
+    "get_handle",
+    "policy",
+    "async",
+    "startup",
+    "hover",
+    "pool",
+    "opacity",
+    "style_watch",
+    "query",
+    "profile",
+    "window_id",
+};
+
+static uint64_t steady_ns() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const uint64_t trace_base_ns = steady_ns();
+
+uint64_t trace_now_ns() {
+    // 加1保证有效的时间戳不为0
+    return steady_ns() - trace_base_ns + 1;
+}
+
+void trace_set_level(int level) {
+    trace_level = level;
+}
+
+int trace_get_level() {
+    return trace_level.load(std::memory_order_relaxed);
+}
+
+void trace_set_print_level(int level) {
+    trace_print_level = level;
+}
+
+int trace_get_print_level() {
+    return trace_print_level.load(std::memory_order_relaxed);
+}
+
+void trace_set_sink(TraceSink sink) {
+    trace_sink = sink;
+}
+
+bool trace_is_enabled(int level) {
+    return level <= trace_level.load(std::memory_order_relaxed) ||
+           level <= trace_print_level.load(std::memory_order_relaxed);
+}
+
+void trace_record(int level, TraceOp op, uint32_t window_id, bool ok, uint64_t duration_ns, const char* message) {
+    TraceEvent event;
+    event.timestamp_ns = trace_now_ns();
+    event.duration_ns = duration_ns;
+    event.window_id = window_id;
+    event.op = op;
+    event.level = (uint8_t)level;
+    event.ok = ok;
+    event.message = message;
+
+    if (level <= trace_level.load(std::memory_order_relaxed)) {
+        uint64_t index = trace_write_index.fetch_add(1, std::memory_order_relaxed);
+        TraceSlot& slot = trace_slots[index & TRACE_MASK];
+        slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.words[0].store(event.timestamp_ns, std::memory_order_relaxed);
+        slot.words[1].store(duration_ns, std::memory_order_relaxed);
+        slot.words[2].store((uint64_t)window_id | ((uint64_t)op << 32) | ((uint64_t)event.level << 48) | ((uint64_t)ok << 56),
+                            std::memory_order_relaxed);
+        slot.words[3].store((uint64_t)(uintptr_t)message, std::memory_order_relaxed);
+        slot.sequence.store(index * 2 + 2, std::memory_order_release);
+    }
+
+    TraceSink sink = trace_sink.load(std::memory_order_acquire);
+    if (sink && level <= trace_print_level.load(std::memory_order_relaxed)) {
+        sink(event);
+    }
+}
+
+uint64_t trace_snapshot(std::vector<TraceEvent>& r_events) {
+    r_events.clear();
+    uint64_t end = trace_write_index.load(std::memory_order_acquire);
+    uint64_t cleared = trace_clear_index.load(std::memory_order_relaxed);
+    uint64_t begin = end > TRACE_CAPACITY ? end - TRACE_CAPACITY : 0;
+    uint64_t dropped = begin > cleared ? begin - cleared : 0;
+    if (begin < cleared) {
+        begin = cleared;
+    }
+
+    r_events.reserve((size_t)(end - begin));
+    for (uint64_t index = begin; index < end; index++) {
+        const TraceSlot& slot = trace_slots[index & TRACE_MASK];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != index * 2 + 2) {
+            dropped++; // 正在写入或已被更新的事件覆盖
+            continue;
+        }
+        uint64_t words[4];
+        for (int i = 0; i < 4; i++) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            dropped++;
+            continue;
+        }
+
+        TraceEvent event;
+        event.timestamp_ns = words[0];
+        event.duration_ns = words[1];
+        event.window_id = (uint32_t)words[2];
+        event.op = (TraceOp)((words[2] >> 32) & 0xFFFF);
+        event.level = (uint8_t)(words[2] >> 48);
+        event.ok = ((words[2] >> 56) & 1) != 0;
+        event.message = (const char*)(uintptr_t)words[3];
+        r_events.push_back(event);
+    }
+    return dropped;
+}
+
+void trace_clear() {
+    trace_clear_index = trace_write_index.load();
+}
+
+const char* trace_level_name(int level) {
+    switch (level) {
+        case TRACE_LEVEL_ERROR:
+            return "ERROR";
+        case TRACE_LEVEL_WARNING:
+            return "WARNING";
+        case TRACE_LEVEL_INFO:
+            return "INFO";
+        case TRACE_LEVEL_DEBUG:
+            return "DEBUG";
+    }
+    return "NONE";
+}
+
+const char* trace_op_name(TraceOp op) {
+    return op < TRACE_OP_COUNT ? TRACE_OP_NAMES[op] : "unknown";
+}
+
+std::string trace_format_event(const TraceEvent& event) {
+    // [秒.微秒] 级别 操作 window=ID ok/failed (耗时) 消息
+    char buffer[256];
+    int length = snprintf(buffer, sizeof(buffer), "[%10.6f] %-7s %s", event.timestamp_ns / 1e9,
+                          trace_level_name(event.level), trace_op_name(event.op));
+    std::string line(buffer, length > 0 ? (size_t)length : 0);
+    if (event.window_id != TRACE_NO_WINDOW) {
+        snprintf(buffer, sizeof(buffer), " window=%u", event.window_id);
+        line += buffer;
+    }
+    line += event.ok ? " ok" : " failed";
+    if (event.duration_ns != 0) {
+        snprintf(buffer, sizeof(buffer), " (%.1f us)", event.duration_ns / 1e3);
+        line += buffer;
+    }
+    if (event.message) {
+        line += ": ";
+        line += event.message;
+    }
+    return line;
+}
+
+static void write_u16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void write_u32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+static void write_u64(uint8_t* p, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+void trace_serialize(const std::vector<TraceEvent>& events, uint64_t dropped, std::vector<uint8_t>& r_bytes) {
+    const size_t header_size = 16;
+    const size_t record_size = 32;
+    r_bytes.assign(header_size + events.size() * record_size, 0);
+
+    uint8_t* p = r_bytes.data();
+    memcpy(p, "HTTR", 4);
+    write_u16(p + 4, 1);
+    write_u16(p + 6, (uint16_t)record_size);
+    write_u32(p + 8, (uint32_t)events.size());
+    write_u32(p + 12, (uint32_t)(dropped > 0xFFFFFFFFu ? 0xFFFFFFFFu : dropped));
+
+    p += header_size;
+    for (const TraceEvent& event : events) {
+        write_u64(p, event.timestamp_ns);
+        write_u64(p + 8, event.duration_ns);
+        write_u32(p + 16, event.window_id);
+        write_u16(p + 20, (uint16_t)event.op);
+        p[22] = event.level;
+        p[23] = event.ok ? 1 : 0;
+        p += record_size;
+    }
+}
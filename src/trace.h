@@ -0,0 +1,137 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// 诊断事件：固定大小的无锁环形缓冲区 + 分级输出
+// 事件只记录时间戳、窗口ID、操作、结果与耗时，不格式化字符串；需要时再导出为文本或二进制。
+// 级别超过编译期上限（HIDE_TASKBAR_TRACE_MAX_LEVEL）的记录语句在编译时被移除，
+// 运行时再按记录级别与输出级别过滤。不依赖Godot，执行线程也可以记录。
+
+#include "op_stats.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum TraceLevel {
+    TRACE_LEVEL_NONE = 0,
+    TRACE_LEVEL_ERROR = 1,
+    TRACE_LEVEL_WARNING = 2,
+    TRACE_LEVEL_INFO = 3,
+    TRACE_LEVEL_DEBUG = 4,
+};
+
+// 编译期上限：debug构建保留全部级别，release构建只保留警告与错误（SCons的trace_level参数可覆盖）
+#ifndef HIDE_TASKBAR_TRACE_MAX_LEVEL
+#ifdef NDEBUG
+#define HIDE_TASKBAR_TRACE_MAX_LEVEL 2
+#else
+#define HIDE_TASKBAR_TRACE_MAX_LEVEL 4
+#endif
+#endif
+
+enum TraceOp : uint16_t {
+    TRACE_OP_LIFECYCLE,
+    TRACE_OP_BACKEND,
+    TRACE_OP_RESOLVE,
+    TRACE_OP_HIDE,
+    TRACE_OP_SHOW,
+    TRACE_OP_IS_VISIBLE,
+    TRACE_OP_SET_CLICKABLE,
+    TRACE_OP_IS_CLICKABLE,
+    TRACE_OP_CLICK_MASK,
+    TRACE_OP_GET_HANDLE,
+    TRACE_OP_POLICY,
+    TRACE_OP_ASYNC,
+    TRACE_OP_STARTUP,
+    TRACE_OP_HOVER,
+    TRACE_OP_POOL,
+    TRACE_OP_OPACITY,
+    TRACE_OP_STYLE_WATCH,
+    TRACE_OP_QUERY,
+    TRACE_OP_PROFILE,
+    TRACE_OP_WINDOW_ID,
+    TRACE_OP_COUNT,
+};
+
+static_assert(TRACE_OP_COUNT <= OP_STATS_MAX_OPS, "op_stats counts calls by TraceOp");
+
+// 没有对应窗口时的窗口ID
+static const uint32_t TRACE_NO_WINDOW = 0xFFFFFFFFu;
+
+struct TraceEvent {
+    uint64_t timestamp_ns = 0;    // 相对于进程内第一次记录
+    uint64_t duration_ns = 0;     // 0表示没有计时
+    uint32_t window_id = TRACE_NO_WINDOW;
+    TraceOp op = TRACE_OP_LIFECYCLE;
+    uint8_t level = TRACE_LEVEL_NONE;
+    bool ok = false;
+    const char* message = nullptr; // 只能是字符串常量
+};
+
+// 达到输出级别的事件交给输出回调（在记录事件的线程上调用）
+typedef void (*TraceSink)(const TraceEvent& event);
+
+// 环形缓冲区容量（事件数），写满后覆盖最旧的事件
+static const size_t TRACE_CAPACITY = 4096;
+
+uint64_t trace_now_ns();
+
+void trace_set_level(int level);
+int trace_get_level();
+void trace_set_print_level(int level);
+int trace_get_print_level();
+void trace_set_sink(TraceSink sink);
+
+bool trace_is_enabled(int level);
+void trace_record(int level, TraceOp op, uint32_t window_id, bool ok, uint64_t duration_ns, const char* message);
+
+// 按时间顺序复制缓冲区中的事件，返回被覆盖的事件数量
+uint64_t trace_snapshot(std::vector<TraceEvent>& r_events);
+void trace_clear();
+
+const char* trace_level_name(int level);
+const char* trace_op_name(TraceOp op);
+std::string trace_format_event(const TraceEvent& event);
+
+// 二进制导出格式（小端）：
+// 16字节头：magic "HTTR"、u16版本(1)、u16记录大小(32)、u32事件数、u32被覆盖的事件数
+// 每条记录32字节：u64时间戳、u64耗时、u32窗口ID、u16操作、u8级别、u8结果、8字节保留
+void trace_serialize(const std::vector<TraceEvent>& events, uint64_t dropped, std::vector<uint8_t>& r_bytes);
+
+#define HIDE_TASKBAR_TRACE(level, op, window_id, ok, message)                              \
+    do {                                                                                   \
+        if ((level) <= HIDE_TASKBAR_TRACE_MAX_LEVEL && trace_is_enabled(level)) {          \
+            trace_record((level), (op), (window_id), (ok), 0, (message));                  \
+        }                                                                                  \
+    } while (0)
+
+// 计时的操作：构造时计入调用次数并开始计时，finish时记录（成功为DEBUG级，失败为WARNING级）
+class TraceScope {
+public:
+    TraceScope(TraceOp p_op, uint32_t p_window_id = TRACE_NO_WINDOW) :
+            op(p_op), window_id(p_window_id) {
+        stats_record_call(op);
+        if (TRACE_LEVEL_WARNING <= HIDE_TASKBAR_TRACE_MAX_LEVEL && trace_is_enabled(TRACE_LEVEL_WARNING)) {
+            start_ns = trace_now_ns();
+        }
+    }
+
+    void set_window_id(uint32_t p_window_id) { window_id = p_window_id; }
+
+    // 返回ok，方便直接return
+    bool finish(bool ok, const char* failure_message = nullptr) {
+        int level = ok ? TRACE_LEVEL_DEBUG : TRACE_LEVEL_WARNING;
+        if (level <= HIDE_TASKBAR_TRACE_MAX_LEVEL && start_ns != 0 && trace_is_enabled(level)) {
+            trace_record(level, op, window_id, ok, trace_now_ns() - start_ns, ok ? nullptr : failure_message);
+        }
+        return ok;
+    }
+
+private:
+    TraceOp op;
+    uint32_t window_id;
+    uint64_t start_ns = 0;
+};
+
+#endif // TRACE_H
@@ -0,0 +1,35 @@
+#include "window_backend.h"
+#include "window_backend_fake.h"
+
+std::unique_ptr<WindowBackend> create_default_window_backend() {
+#if defined(_WIN32)
+    return create_win32_window_backend();
+#elif defined(HIDE_TASKBAR_X11)
+    return create_x11_window_backend();
+#else
+    return create_null_window_backend();
+#endif
+}
+
+std::unique_ptr<WindowBackend> create_window_backend(const std::string& name) {
+    if (name.empty() || name == "default") {
+        return create_default_window_backend();
+    }
+    if (name == "null") {
+        return create_null_window_backend();
+    }
+    if (name == "fake") {
+        return std::unique_ptr<WindowBackend>(new FakeWindowBackend());
+    }
+#ifdef _WIN32
+    if (name == "win32") {
+        return create_win32_window_backend();
+    }
+#endif
+#ifdef HIDE_TASKBAR_X11
+    if (name == "x11") {
+        return create_x11_window_backend();
+    }
+#endif
+    return nullptr;
+}
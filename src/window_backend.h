@@ -0,0 +1,115 @@
+#ifndef WINDOW_BACKEND_H
+#define WINDOW_BACKEND_H
+
+#include "click_mask.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 原生窗口句柄（Windows下为HWND，X11下为Window）
+typedef int64_t NativeWindowHandle;
+
+// 平台无关的窗口样式位，只包含本扩展管理的部分
+enum WindowStyleFlags : uint32_t {
+    WINDOW_STYLE_APP_WINDOW = 1u << 0,   // 强制显示在任务栏（WS_EX_APPWINDOW）
+    WINDOW_STYLE_TOOL_WINDOW = 1u << 1,  // 工具窗口，不显示在任务栏（WS_EX_TOOLWINDOW）
+    WINDOW_STYLE_LAYERED = 1u << 2,      // 分层窗口（WS_EX_LAYERED）
+    WINDOW_STYLE_TRANSPARENT = 1u << 3,  // 鼠标穿透（WS_EX_TRANSPARENT）
+};
+
+static const uint32_t WINDOW_STYLE_TASKBAR_MASK = WINDOW_STYLE_APP_WINDOW | WINDOW_STYLE_TOOL_WINDOW;
+static const uint32_t WINDOW_STYLE_CLICK_THROUGH_MASK = WINDOW_STYLE_LAYERED | WINDOW_STYLE_TRANSPARENT;
+
+// 一个窗口的样式变更，ok由后端填写
+struct WindowStyleUpdate {
+    NativeWindowHandle handle = 0;
+    uint32_t old_style = 0;
+    uint32_t new_style = 0;
+    bool ok = false;
+};
+
+// 一个窗口的整体不透明度变更（0为完全透明，255为不透明），ok由后端填写
+struct WindowOpacityUpdate {
+    NativeWindowHandle handle = 0;
+    uint8_t opacity = 255;
+    bool ok = false;
+};
+
+// 窗口即将显示时的回调：current_style为当前样式，返回true并填写r_style时在显示前写入新样式
+typedef bool (*WindowShowHook)(NativeWindowHandle handle, uint32_t current_style, uint32_t& r_style, void* userdata);
+
+// 平台后端接口
+// 前端（HideTaskBarInWindowsSystem）只通过这里访问系统，便于在没有对应平台的机器上用伪后端测试。
+// apply_styles、read_style、is_valid_window、get_cursor_position与透明度读写可能在异步执行器、
+// 悬停跟踪线程或渐变线程上调用，与主线程并发。
+class WindowBackend {
+public:
+    virtual ~WindowBackend() {}
+
+    virtual const char* get_name() const = 0;
+    virtual bool is_supported() const { return true; }
+
+    // 句柄是否仍然指向一个存在的窗口
+    virtual bool is_valid_window(NativeWindowHandle handle) { return handle != 0; }
+
+    // 读取受管理的样式位
+    virtual bool read_style(NativeWindowHandle handle, uint32_t& r_style) = 0;
+
+    // 一次提交一批样式变更，每个窗口只出现一次
+    virtual void apply_styles(WindowStyleUpdate* updates, size_t count) = 0;
+
+    // DisplayServer拿不到主窗口句柄时的备用查找
+    virtual NativeWindowHandle find_main_window() { return 0; }
+
+    // 设置输入区域：只有rects覆盖的部分接收鼠标，其余部分穿透（count为0时整个窗口穿透）
+    virtual bool set_input_region(NativeWindowHandle handle, const MaskRect* rects, size_t count) { return false; }
+    // 恢复默认输入区域（整个窗口）
+    virtual bool clear_input_region(NativeWindowHandle handle) { return false; }
+
+    // 安装显示前钩子（hook为nullptr时卸载），只对调用线程创建的窗口生效。
+    // 不支持的后端返回false，前端改为在窗口显示后应用样式。
+    virtual bool set_show_hook(WindowShowHook hook, void* userdata) { return false; }
+
+    // 光标相对窗口左上角的位置（悬停跟踪线程调用），不支持时返回false
+    virtual bool get_cursor_position(NativeWindowHandle handle, int32_t& r_x, int32_t& r_y) { return false; }
+
+    // 窗口整体不透明度：由系统/合成器混合，不重新绘制窗口内容。
+    // 没有设置过时读取结果为255；不支持的后端返回false
+    virtual bool read_opacity(NativeWindowHandle handle, uint8_t& r_opacity) { return false; }
+    // 半透明是否需要LAYERED样式位（Win32分层窗口）。为true时管理器在同一次提交中先经apply_styles加上LAYERED，
+    // apply_opacity本身不修改样式；X11等与样式无关的后端返回false
+    virtual bool opacity_needs_layered() const { return false; }
+    // 一次提交一批不透明度变更，每个窗口只出现一次
+    virtual void apply_opacity(WindowOpacityUpdate* updates, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            updates[i].ok = false;
+        }
+    }
+
+    // 外部样式变化：开始/停止监视窗口的受管理样式，只在主线程调用（Win32下只对调用线程创建的窗口生效）。
+    // 不支持的后端返回false。本扩展自己的写入同样会被报告，由前端与影子状态比较后过滤。
+    virtual bool watch_style_changes(NativeWindowHandle handle, bool enabled) { return false; }
+    // 取回自上次调用后受管理样式可能被修改的窗口（追加到r_handles，不重复），不阻塞，返回追加的数量
+    virtual size_t poll_style_changes(std::vector<NativeWindowHandle>& r_handles) { return 0; }
+
+    // 处理其他线程同步发给调用线程窗口的消息（Win32），等待异步执行器时调用
+    virtual void process_pending_messages() {}
+};
+
+std::unique_ptr<WindowBackend> create_null_window_backend();
+#ifdef _WIN32
+std::unique_ptr<WindowBackend> create_win32_window_backend();
+#endif
+#ifdef HIDE_TASKBAR_X11
+std::unique_ptr<WindowBackend> create_x11_window_backend();
+#endif
+
+// 当前平台的默认后端
+std::unique_ptr<WindowBackend> create_default_window_backend();
+// 按名称创建后端："default"、"null"、"fake"、"win32"、"x11"，未知名称返回空
+std::unique_ptr<WindowBackend> create_window_backend(const std::string& name);
+
+#endif // WINDOW_BACKEND_H
@@ -0,0 +1,274 @@
+#include "window_backend_fake.h"
+
+#include <algorithm>
+
+bool FakeWindowBackend::is_valid_window(NativeWindowHandle handle) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return windows.find(handle) != windows.end();
+}
+
+bool FakeWindowBackend::read_style(NativeWindowHandle handle, uint32_t& r_style) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    counters.style_reads++;
+    auto it = windows.find(handle);
+    if (it == windows.end()) {
+        return false;
+    }
+    r_style = it->second.style;
+    return true;
+}
+
+void FakeWindowBackend::apply_styles(WindowStyleUpdate* updates, size_t count) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    counters.batches++;
+    for (size_t i = 0; i < count; i++) {
+        WindowStyleUpdate& update = updates[i];
+        auto it = windows.find(update.handle);
+        if (it == windows.end()) {
+            update.ok = false;
+            continue;
+        }
+
+        FakeWindow& window = it->second;
+        if (window.fail_writes) {
+            update.ok = false;
+            continue;
+        }
+        if (((window.style ^ update.new_style) & WINDOW_STYLE_TASKBAR_MASK) && window.visible) {
+            counters.hide_show_cycles++;
+        }
+        // 与Win32一致：自己的写入同样会被报告
+        if (window.style_watched && ((window.style ^ update.new_style) & (WINDOW_STYLE_TASKBAR_MASK | WINDOW_STYLE_CLICK_THROUGH_MASK))) {
+            note_style_change(update.handle);
+        }
+        window.style = update.new_style;
+        window.style_writes++;
+        counters.style_writes++;
+        update.ok = true;
+    }
+}
+
+NativeWindowHandle FakeWindowBackend::find_main_window() {
+    return get_window_handle(0);
+}
+
+bool FakeWindowBackend::set_input_region(NativeWindowHandle handle, const MaskRect* rects, size_t count) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it == windows.end()) {
+        return false;
+    }
+    it->second.has_input_region = true;
+    it->second.input_region_rects = count;
+    counters.region_updates++;
+    return true;
+}
+
+bool FakeWindowBackend::clear_input_region(NativeWindowHandle handle) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it == windows.end()) {
+        return false;
+    }
+    it->second.has_input_region = false;
+    it->second.input_region_rects = 0;
+    counters.region_updates++;
+    return true;
+}
+
+bool FakeWindowBackend::set_show_hook(WindowShowHook hook, void* userdata) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    show_hook = hook;
+    show_hook_userdata = userdata;
+    return true;
+}
+
+bool FakeWindowBackend::get_cursor_position(NativeWindowHandle handle, int32_t& r_x, int32_t& r_y) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    counters.cursor_queries++;
+    auto it = windows.find(handle);
+    if (it == windows.end() || !it->second.has_cursor) {
+        return false;
+    }
+    r_x = it->second.cursor_x;
+    r_y = it->second.cursor_y;
+    return true;
+}
+
+bool FakeWindowBackend::read_opacity(NativeWindowHandle handle, uint8_t& r_opacity) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it == windows.end()) {
+        return false;
+    }
+    r_opacity = it->second.opacity;
+    return true;
+}
+
+void FakeWindowBackend::apply_opacity(WindowOpacityUpdate* updates, size_t count) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    counters.batches++;
+    for (size_t i = 0; i < count; i++) {
+        auto it = windows.find(updates[i].handle);
+        if (it == windows.end() || it->second.fail_writes) {
+            updates[i].ok = false;
+            continue;
+        }
+        // 与Win32一致：不是分层窗口时写入失败（LAYERED由管理器先经apply_styles加上）
+        if (!(it->second.style & WINDOW_STYLE_LAYERED)) {
+            updates[i].ok = false;
+            continue;
+        }
+        it->second.opacity = updates[i].opacity;
+        counters.opacity_writes++;
+        updates[i].ok = true;
+    }
+}
+
+void FakeWindowBackend::set_cursor_position(NativeWindowHandle handle, int32_t x, int32_t y, bool inside) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it != windows.end()) {
+        it->second.has_cursor = inside;
+        it->second.cursor_x = x;
+        it->second.cursor_y = y;
+    }
+}
+
+void FakeWindowBackend::show_window(NativeWindowHandle handle) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it == windows.end() || it->second.visible) {
+        return;
+    }
+
+    FakeWindow& window = it->second;
+    uint32_t target = window.style;
+    if (show_hook && show_hook(handle, window.style, target, show_hook_userdata) && target != window.style) {
+        window.style = target;
+        window.style_writes++;
+        counters.style_writes++;
+        counters.show_hook_writes++;
+    }
+    window.visible = true;
+}
+
+void FakeWindowBackend::hide_window(NativeWindowHandle handle) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it != windows.end()) {
+        it->second.visible = false;
+    }
+}
+
+NativeWindowHandle FakeWindowBackend::create_window(uint32_t window_id, uint32_t style, bool visible) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    NativeWindowHandle handle = next_handle;
+    next_handle += 0x10;
+
+    FakeWindow window;
+    window.window_id = window_id;
+    window.style = style;
+    window.visible = visible;
+    windows[handle] = window;
+    window_ids[window_id] = handle;
+    return handle;
+}
+
+void FakeWindowBackend::destroy_window(NativeWindowHandle handle) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it == windows.end()) {
+        return;
+    }
+
+    auto id = window_ids.find(it->second.window_id);
+    if (id != window_ids.end() && id->second == handle) {
+        window_ids.erase(id);
+    }
+    windows.erase(it);
+}
+
+NativeWindowHandle FakeWindowBackend::get_window_handle(uint32_t window_id) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = window_ids.find(window_id);
+    return it != window_ids.end() ? it->second : 0;
+}
+
+const FakeWindowBackend::FakeWindow* FakeWindowBackend::get_window(NativeWindowHandle handle) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    return it != windows.end() ? &it->second : nullptr;
+}
+
+void FakeWindowBackend::set_fail_writes(NativeWindowHandle handle, bool fail) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it != windows.end()) {
+        it->second.fail_writes = fail;
+    }
+}
+
+bool FakeWindowBackend::set_external_style(NativeWindowHandle handle, uint32_t style) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it == windows.end()) {
+        return false;
+    }
+    if (it->second.style_watched && it->second.style != style) {
+        note_style_change(handle);
+    }
+    it->second.style = style;
+    return true;
+}
+
+bool FakeWindowBackend::watch_style_changes(NativeWindowHandle handle, bool enabled) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = windows.find(handle);
+    if (it == windows.end()) {
+        return false;
+    }
+    it->second.style_watched = enabled;
+    return true;
+}
+
+size_t FakeWindowBackend::poll_style_changes(std::vector<NativeWindowHandle>& r_handles) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    size_t count = 0;
+    for (NativeWindowHandle handle : style_changes) {
+        if (std::find(r_handles.begin(), r_handles.end(), handle) == r_handles.end()) {
+            r_handles.push_back(handle);
+            count++;
+        }
+    }
+    style_changes.clear();
+    return count;
+}
+
+void FakeWindowBackend::note_style_change(NativeWindowHandle handle) {
+    if (std::find(style_changes.begin(), style_changes.end(), handle) == style_changes.end()) {
+        style_changes.push_back(handle);
+    }
+}
+
+FakeWindowBackend::Counters FakeWindowBackend::get_counters() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return counters;
+}
+
+void FakeWindowBackend::reset_counters() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    counters = Counters();
+}
+
+NativeWindowHandle FakeWindowBackend::lookup_handle(uint32_t window_id, void* userdata) {
+    FakeWindowBackend* backend = (FakeWindowBackend*)userdata;
+    std::lock_guard<std::recursive_mutex> lock(backend->mutex);
+    backend->counters.lookups++;
+
+    NativeWindowHandle handle = backend->get_window_handle(window_id);
+    if (handle == 0 && backend->auto_create) {
+        handle = backend->create_window(window_id);
+    }
+    return handle;
+}
@@ -0,0 +1,100 @@
+#ifndef WINDOW_BACKEND_FAKE_H
+#define WINDOW_BACKEND_FAKE_H
+
+#include "window_backend.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// 内存中的伪后端：模拟扩展样式与句柄查找，用于在Linux上测试与基准测试
+// 行为与Win32后端保持一致：可见窗口切换任务栏样式时计一次隐藏/显示循环。
+// 所有操作加锁，可以配合异步执行器使用（显示前钩子可能回调句柄查找，因此为递归锁）。
+class FakeWindowBackend : public WindowBackend {
+public:
+    struct FakeWindow {
+        uint32_t window_id = 0;
+        uint32_t style = 0;
+        bool visible = true;
+        uint64_t style_writes = 0;
+        bool has_input_region = false;
+        size_t input_region_rects = 0;
+        bool has_cursor = false;
+        int32_t cursor_x = 0;
+        int32_t cursor_y = 0;
+        uint8_t opacity = 255;
+        bool style_watched = false;
+        bool fail_writes = false;
+    };
+
+    // 调用计数，用于确认缓存、影子状态与批处理是否生效
+    struct Counters {
+        uint64_t lookups = 0;
+        uint64_t style_reads = 0;
+        uint64_t style_writes = 0;
+        uint64_t batches = 0;
+        uint64_t hide_show_cycles = 0;
+        uint64_t region_updates = 0;
+        uint64_t show_hook_writes = 0;
+        uint64_t cursor_queries = 0;
+        uint64_t opacity_writes = 0;
+    };
+
+    const char* get_name() const override { return "fake"; }
+
+    bool is_valid_window(NativeWindowHandle handle) override;
+    bool read_style(NativeWindowHandle handle, uint32_t& r_style) override;
+    void apply_styles(WindowStyleUpdate* updates, size_t count) override;
+    NativeWindowHandle find_main_window() override;
+    bool set_input_region(NativeWindowHandle handle, const MaskRect* rects, size_t count) override;
+    bool clear_input_region(NativeWindowHandle handle) override;
+    bool set_show_hook(WindowShowHook hook, void* userdata) override;
+    bool get_cursor_position(NativeWindowHandle handle, int32_t& r_x, int32_t& r_y) override;
+    bool read_opacity(NativeWindowHandle handle, uint8_t& r_opacity) override;
+    bool opacity_needs_layered() const override { return true; }
+    void apply_opacity(WindowOpacityUpdate* updates, size_t count) override;
+    bool watch_style_changes(NativeWindowHandle handle, bool enabled) override;
+    size_t poll_style_changes(std::vector<NativeWindowHandle>& r_handles) override;
+
+    NativeWindowHandle create_window(uint32_t window_id, uint32_t style = WINDOW_STYLE_APP_WINDOW, bool visible = true);
+    void destroy_window(NativeWindowHandle handle);
+    NativeWindowHandle get_window_handle(uint32_t window_id) const;
+    const FakeWindow* get_window(NativeWindowHandle handle) const;
+
+    // 模拟窗口显示/隐藏，显示前调用显示前钩子
+    void show_window(NativeWindowHandle handle);
+    void hide_window(NativeWindowHandle handle);
+
+    // 模拟光标移动（相对窗口左上角），inside为false时表示光标不在窗口所在屏幕
+    void set_cursor_position(NativeWindowHandle handle, int32_t x, int32_t y, bool inside = true);
+
+    // 模拟其他程序修改样式（监视中的窗口会被报告）
+    bool set_external_style(NativeWindowHandle handle, uint32_t style);
+
+    // 模拟系统调用失败：之后的样式与不透明度写入都返回失败，窗口状态不变
+    void set_fail_writes(NativeWindowHandle handle, bool fail);
+
+    // 未知窗口ID查询时自动创建伪窗口（在Godot中切换到伪后端时使用）
+    void set_auto_create(bool enabled) { auto_create = enabled; }
+
+    // 可直接作为WindowStyleManager的句柄查询回调，userdata为FakeWindowBackend*
+    static NativeWindowHandle lookup_handle(uint32_t window_id, void* userdata);
+
+    Counters get_counters() const;
+    void reset_counters();
+
+private:
+    void note_style_change(NativeWindowHandle handle);
+
+    std::unordered_map<NativeWindowHandle, FakeWindow> windows;
+    std::unordered_map<uint32_t, NativeWindowHandle> window_ids;
+    NativeWindowHandle next_handle = 0x1000;
+    bool auto_create = false;
+    WindowShowHook show_hook = nullptr;
+    void* show_hook_userdata = nullptr;
+    Counters counters;
+    std::vector<NativeWindowHandle> style_changes;
+    mutable std::recursive_mutex mutex;
+};
+
+#endif // WINDOW_BACKEND_FAKE_H
@@ -0,0 +1,22 @@
+#include "window_backend.h"
+
+// 不支持的平台：所有操作都失败，前端据此返回false
+class NullWindowBackend : public WindowBackend {
+public:
+    const char* get_name() const override { return "null"; }
+    bool is_supported() const override { return false; }
+
+    bool read_style(NativeWindowHandle handle, uint32_t& r_style) override {
+        return false;
+    }
+
+    void apply_styles(WindowStyleUpdate* updates, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            updates[i].ok = false;
+        }
+    }
+};
+
+std::unique_ptr<WindowBackend> create_null_window_backend() {
+    return std::unique_ptr<WindowBackend>(new NullWindowBackend());
+}
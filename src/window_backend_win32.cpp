@@ -0,0 +1,502 @@
+#ifdef _WIN32
+
+#include "window_backend.h"
+
+#include <windows.h>
+#include <shobjidl.h>
+#include <tlhelp32.h>
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+static const LONG_PTR MANAGED_EX_STYLE = WS_EX_APPWINDOW | WS_EX_TOOLWINDOW | WS_EX_LAYERED | WS_EX_TRANSPARENT;
+
+static uint32_t from_ex_style(LONG_PTR exStyle) {
+    uint32_t style = 0;
+    if (exStyle & WS_EX_APPWINDOW) style |= WINDOW_STYLE_APP_WINDOW;
+    if (exStyle & WS_EX_TOOLWINDOW) style |= WINDOW_STYLE_TOOL_WINDOW;
+    if (exStyle & WS_EX_LAYERED) style |= WINDOW_STYLE_LAYERED;
+    if (exStyle & WS_EX_TRANSPARENT) style |= WINDOW_STYLE_TRANSPARENT;
+    return style;
+}
+
+static LONG_PTR to_ex_style(uint32_t style) {
+    LONG_PTR exStyle = 0;
+    if (style & WINDOW_STYLE_APP_WINDOW) exStyle |= WS_EX_APPWINDOW;
+    if (style & WINDOW_STYLE_TOOL_WINDOW) exStyle |= WS_EX_TOOLWINDOW;
+    if (style & WINDOW_STYLE_LAYERED) exStyle |= WS_EX_LAYERED;
+    if (style & WINDOW_STYLE_TRANSPARENT) exStyle |= WS_EX_TRANSPARENT;
+    return exStyle;
+}
+
+// 写入受管理的样式位，保留本扩展不管理的部分
+static bool write_managed_style(HWND hwnd, uint32_t old_style, uint32_t new_style) {
+    LONG_PTR oldExStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
+    if (oldExStyle == 0) {
+        return false;
+    }
+    LONG_PTR exStyle = (oldExStyle & ~MANAGED_EX_STYLE) | to_ex_style(new_style);
+    SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
+
+    // 按系统中的实际样式判断：影子状态可能与外部修改后的系统不一致，不能覆盖已有的透明度
+    if (!(oldExStyle & WS_EX_LAYERED) && (exStyle & WS_EX_LAYERED)) {
+        // 设置透明度为完全不透明但保持穿透
+        SetLayeredWindowAttributes(hwnd, 0, 255, LWA_ALPHA);
+    }
+    return true;
+}
+
+// 显示前钩子
+// WH_CALLWNDPROC在窗口过程处理WM_SHOWWINDOW之前调用，此时窗口还不可见，
+// 直接改写样式即可，任务栏按钮按新样式创建，不需要隐藏/显示循环。
+// 系统钩子按线程安装，所有后端实例的回调共用一个。
+struct Win32ShowHook {
+    const void* owner = nullptr;
+    WindowShowHook hook = nullptr;
+    void* userdata = nullptr;
+};
+
+// 外部样式变化
+// 任何进程调用SetWindowLongPtr修改扩展样式后，系统都会向窗口线程发送WM_STYLECHANGED，
+// 同一个钩子就能看到，不需要轮询。钩子在窗口线程（主线程）运行，只记录受管理样式位变化的窗口。
+struct Win32StyleWatch {
+    const void* owner = nullptr;
+    std::unordered_set<HWND> windows;
+    std::vector<HWND> changed;
+};
+
+static std::vector<Win32ShowHook> win32_show_hooks;
+static std::vector<Win32StyleWatch> win32_style_watches;
+static HHOOK win32_show_hhook = NULL;
+
+static LRESULT CALLBACK win32_show_hook_proc(int code, WPARAM wParam, LPARAM lParam) {
+    if (code == HC_ACTION) {
+        const CWPSTRUCT* message = (const CWPSTRUCT*)lParam;
+        HWND hwnd = message->hwnd;
+        if (message->message == WM_STYLECHANGED && message->wParam == (WPARAM)GWL_EXSTYLE) {
+            const STYLESTRUCT* change = (const STYLESTRUCT*)message->lParam;
+            if (((LONG_PTR)(change->styleOld ^ change->styleNew) & MANAGED_EX_STYLE) != 0) {
+                for (Win32StyleWatch& watch : win32_style_watches) {
+                    if (watch.windows.count(hwnd) && std::find(watch.changed.begin(), watch.changed.end(), hwnd) == watch.changed.end()) {
+                        watch.changed.push_back(hwnd);
+                    }
+                }
+            }
+        } else if (message->message == WM_SHOWWINDOW && message->wParam && !IsWindowVisible(hwnd)
+                && !(GetWindowLongPtr(hwnd, GWL_STYLE) & WS_CHILD)) {
+            uint32_t current = from_ex_style(GetWindowLongPtr(hwnd, GWL_EXSTYLE));
+            for (const Win32ShowHook& entry : win32_show_hooks) {
+                uint32_t target = current;
+                if (entry.hook((NativeWindowHandle)hwnd, current, target, entry.userdata)) {
+                    if (target != current) {
+                        write_managed_style(hwnd, current, target);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    return CallNextHookEx(win32_show_hhook, code, wParam, lParam);
+}
+
+// 显示前钩子或样式监视还在使用时保持安装
+static bool update_win32_hook() {
+    bool wanted = !win32_show_hooks.empty() || !win32_style_watches.empty();
+    if (wanted && !win32_show_hhook) {
+        win32_show_hhook = SetWindowsHookEx(WH_CALLWNDPROC, win32_show_hook_proc, NULL, GetCurrentThreadId());
+        return win32_show_hhook != NULL;
+    }
+    if (!wanted && win32_show_hhook) {
+        UnhookWindowsHookEx(win32_show_hhook);
+        win32_show_hhook = NULL;
+    }
+    return true;
+}
+
+static bool set_win32_show_hook(const void* owner, WindowShowHook hook, void* userdata) {
+    for (size_t i = 0; i < win32_show_hooks.size(); i++) {
+        if (win32_show_hooks[i].owner == owner) {
+            win32_show_hooks.erase(win32_show_hooks.begin() + i);
+            break;
+        }
+    }
+    if (hook) {
+        Win32ShowHook entry;
+        entry.owner = owner;
+        entry.hook = hook;
+        entry.userdata = userdata;
+        win32_show_hooks.push_back(entry);
+    }
+
+    if (!update_win32_hook()) {
+        win32_show_hooks.clear();
+        return false;
+    }
+    return true;
+}
+
+static Win32StyleWatch* find_win32_style_watch(const void* owner) {
+    for (Win32StyleWatch& watch : win32_style_watches) {
+        if (watch.owner == owner) {
+            return &watch;
+        }
+    }
+    return nullptr;
+}
+
+static bool set_win32_style_watch(const void* owner, HWND hwnd, bool enabled) {
+    Win32StyleWatch* watch = find_win32_style_watch(owner);
+    if (enabled) {
+        if (!watch) {
+            win32_style_watches.push_back(Win32StyleWatch());
+            watch = &win32_style_watches.back();
+            watch->owner = owner;
+        }
+        watch->windows.insert(hwnd);
+    } else if (watch) {
+        watch->windows.erase(hwnd);
+        watch->changed.erase(std::remove(watch->changed.begin(), watch->changed.end(), hwnd), watch->changed.end());
+    }
+
+    // 没有监视的窗口时移除整个条目，钩子只在仍有用途时保留
+    if (watch && watch->windows.empty()) {
+        win32_style_watches.erase(win32_style_watches.begin() + (watch - win32_style_watches.data()));
+    }
+    if (!update_win32_hook()) {
+        win32_style_watches.clear();
+        return false;
+    }
+    return true;
+}
+
+// 批量设置窗口位置标志，整批一次提交给系统；批处理失败时逐个调用SetWindowPos
+// 在窗口线程以外（异步执行器）调用时改用SWP_ASYNCWINDOWPOS，请求投递到窗口线程的消息队列，不等待其处理。
+static void set_window_pos_batch(const std::vector<std::pair<HWND, UINT>>& windows) {
+    if (windows.empty()) {
+        return;
+    }
+
+    const UINT base_flags = SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOACTIVATE;
+    if (GetWindowThreadProcessId(windows[0].first, NULL) != GetCurrentThreadId()) {
+        // DeferWindowPos不支持异步，逐个投递
+        for (const auto& window : windows) {
+            SetWindowPos(window.first, NULL, 0, 0, 0, 0, base_flags | SWP_ASYNCWINDOWPOS | window.second);
+        }
+        return;
+    }
+
+    HDWP dwp = BeginDeferWindowPos((int)windows.size());
+    for (const auto& window : windows) {
+        if (!dwp) {
+            break;
+        }
+        dwp = DeferWindowPos(dwp, window.first, NULL, 0, 0, 0, 0, base_flags | window.second);
+    }
+
+    if (dwp && EndDeferWindowPos(dwp)) {
+        return;
+    }
+
+    for (const auto& window : windows) {
+        SetWindowPos(window.first, NULL, 0, 0, 0, 0, base_flags | window.second);
+    }
+}
+
+// 任务栏按钮
+// ITaskbarList是STA对象，按线程创建（异步执行器线程使用自己的实例），线程退出时释放。
+// COM初始化或创建失败时get返回nullptr，调用方退回隐藏/显示循环。
+class Win32TaskbarList {
+public:
+    ~Win32TaskbarList() {
+        if (list) {
+            list->Release();
+        }
+        if (com_initialized) {
+            CoUninitialize();
+        }
+    }
+
+    ITaskbarList* get() {
+        if (tried) {
+            return list;
+        }
+        tried = true;
+
+        // 线程已经以其他模型初始化COM时（RPC_E_CHANGED_MODE）仍然可以创建对象，但不能调用CoUninitialize
+        HRESULT hr = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+        com_initialized = SUCCEEDED(hr);
+        if (!com_initialized && hr != RPC_E_CHANGED_MODE) {
+            return nullptr;
+        }
+        if (FAILED(CoCreateInstance(CLSID_TaskbarList, NULL, CLSCTX_INPROC_SERVER, IID_ITaskbarList, (void**)&list))) {
+            list = nullptr;
+            return nullptr;
+        }
+        if (FAILED(list->HrInit())) {
+            list->Release();
+            list = nullptr;
+        }
+        return list;
+    }
+
+private:
+    ITaskbarList* list = nullptr;
+    bool tried = false;
+    bool com_initialized = false;
+};
+
+static thread_local Win32TaskbarList win32_taskbar_list;
+
+// 与外壳的判断一致：没有TOOLWINDOW的无所有者顶级窗口也显示在任务栏
+static bool win32_on_taskbar(uint32_t style) {
+    return (style & WINDOW_STYLE_APP_WINDOW) || !(style & WINDOW_STYLE_TOOL_WINDOW);
+}
+
+class Win32WindowBackend : public WindowBackend {
+public:
+    ~Win32WindowBackend() override {
+        Win32StyleWatch* watch = find_win32_style_watch(this);
+        if (watch) {
+            win32_style_watches.erase(win32_style_watches.begin() + (watch - win32_style_watches.data()));
+        }
+        set_win32_show_hook(this, nullptr, nullptr);
+    }
+
+    const char* get_name() const override { return "win32"; }
+
+    bool is_valid_window(NativeWindowHandle handle) override {
+        return handle != 0 && IsWindow((HWND)handle);
+    }
+
+    bool read_style(NativeWindowHandle handle, uint32_t& r_style) override {
+        LONG_PTR exStyle = GetWindowLongPtr((HWND)handle, GWL_EXSTYLE);
+        if (exStyle == 0) {
+            return false;
+        }
+        r_style = from_ex_style(exStyle);
+        return true;
+    }
+
+    void apply_styles(WindowStyleUpdate* updates, size_t count) override {
+        // 任务栏只在窗口显示时检查样式。写入样式后通过ITaskbarList直接删除/添加可见窗口的任务栏按钮，
+        // 窗口本身只做FRAMECHANGED重新定位，不隐藏、不闪烁；COM不可用时才整批隐藏再随FRAMECHANGED显示
+        ITaskbarList* taskbar = win32_taskbar_list.get();
+        std::vector<std::pair<HWND, UINT>> batch;
+        std::vector<char> retab(count, 0);
+        std::vector<char> cycle(count, 0);
+        batch.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            HWND hwnd = (HWND)updates[i].handle;
+            if (!((updates[i].old_style ^ updates[i].new_style) & WINDOW_STYLE_TASKBAR_MASK) || !IsWindowVisible(hwnd)) {
+                continue;
+            }
+            if (taskbar) {
+                retab[i] = 1;
+            } else {
+                cycle[i] = 1;
+                batch.push_back(std::make_pair(hwnd, (UINT)SWP_HIDEWINDOW));
+            }
+        }
+        set_window_pos_batch(batch);
+
+        for (size_t i = 0; i < count; i++) {
+            WindowStyleUpdate& update = updates[i];
+            update.ok = write_managed_style((HWND)update.handle, update.old_style, update.new_style);
+        }
+
+        // 每个窗口只做一次FRAMECHANGED重新定位，隐藏过的窗口同时重新显示；
+        // 只切换WS_EX_LAYERED/WS_EX_TRANSPARENT的窗口（穿透、悬停穿透、不透明度）不影响边框，写入样式后立即生效
+        batch.clear();
+        for (size_t i = 0; i < count; i++) {
+            if (((updates[i].old_style ^ updates[i].new_style) & ~WINDOW_STYLE_CLICK_THROUGH_MASK) == 0) {
+                continue;
+            }
+            batch.push_back(std::make_pair((HWND)updates[i].handle, (UINT)(SWP_FRAMECHANGED | (cycle[i] ? SWP_SHOWWINDOW : 0))));
+        }
+        set_window_pos_batch(batch);
+
+        for (size_t i = 0; i < count; i++) {
+            if (!retab[i] || !updates[i].ok) {
+                continue;
+            }
+            HWND hwnd = (HWND)updates[i].handle;
+            if (win32_on_taskbar(updates[i].new_style)) {
+                taskbar->AddTab(hwnd);
+            } else {
+                taskbar->DeleteTab(hwnd);
+            }
+        }
+    }
+
+    NativeWindowHandle find_main_window() override {
+        // Godot在主线程创建窗口，先只枚举当前线程的顶级窗口
+        HWND found_hwnd = find_thread_main_window(GetCurrentThreadId());
+        if (found_hwnd) {
+            return (NativeWindowHandle)found_hwnd;
+        }
+
+        // 再枚举本进程其他线程的窗口，不再遍历整个桌面
+        DWORD current_process_id = GetCurrentProcessId();
+        DWORD current_thread_id = GetCurrentThreadId();
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshot == INVALID_HANDLE_VALUE) {
+            return 0;
+        }
+
+        THREADENTRY32 entry;
+        entry.dwSize = sizeof(entry);
+        if (Thread32First(snapshot, &entry)) {
+            do {
+                if (entry.th32OwnerProcessID == current_process_id && entry.th32ThreadID != current_thread_id) {
+                    found_hwnd = find_thread_main_window(entry.th32ThreadID);
+                }
+            } while (!found_hwnd && Thread32Next(snapshot, &entry));
+        }
+        CloseHandle(snapshot);
+
+        return (NativeWindowHandle)found_hwnd;
+    }
+
+    bool set_input_region(NativeWindowHandle handle, const MaskRect* rects, size_t count) override {
+        // 窗口区域同时裁剪绘制与命中测试，区域外的像素不再显示（count为0时整个窗口被裁掉）
+        size_t size = sizeof(RGNDATAHEADER) + sizeof(RECT) * count;
+        region_buffer.resize(size);
+        RGNDATA* data = (RGNDATA*)region_buffer.data();
+        RECT* out = (RECT*)data->Buffer;
+
+        RECT bounds = { 0, 0, 0, 0 };
+        for (size_t i = 0; i < count; i++) {
+            out[i].left = rects[i].x;
+            out[i].top = rects[i].y;
+            out[i].right = rects[i].x + rects[i].width;
+            out[i].bottom = rects[i].y + rects[i].height;
+            if (i == 0) {
+                bounds = out[i];
+            } else {
+                bounds.left = (std::min)(bounds.left, out[i].left);
+                bounds.top = (std::min)(bounds.top, out[i].top);
+                bounds.right = (std::max)(bounds.right, out[i].right);
+                bounds.bottom = (std::max)(bounds.bottom, out[i].bottom);
+            }
+        }
+
+        data->rdh.dwSize = sizeof(RGNDATAHEADER);
+        data->rdh.iType = RDH_RECTANGLES;
+        data->rdh.nCount = (DWORD)count;
+        data->rdh.nRgnSize = (DWORD)(sizeof(RECT) * count);
+        data->rdh.rcBound = bounds;
+
+        // 一次创建整个区域，不逐个CombineRgn
+        HRGN region = ExtCreateRegion(NULL, (DWORD)size, data);
+        if (!region) {
+            return false;
+        }
+        // 成功后区域归系统所有，失败时需要自己释放
+        if (!SetWindowRgn((HWND)handle, region, TRUE)) {
+            DeleteObject(region);
+            return false;
+        }
+        return true;
+    }
+
+    bool clear_input_region(NativeWindowHandle handle) override {
+        return SetWindowRgn((HWND)handle, NULL, TRUE) != 0;
+    }
+
+    bool get_cursor_position(NativeWindowHandle handle, int32_t& r_x, int32_t& r_y) override {
+        POINT point;
+        if (!GetCursorPos(&point) || !ScreenToClient((HWND)handle, &point)) {
+            return false;
+        }
+        r_x = point.x;
+        r_y = point.y;
+        return true;
+    }
+
+    bool read_opacity(NativeWindowHandle handle, uint8_t& r_opacity) override {
+        LONG_PTR exStyle = GetWindowLongPtr((HWND)handle, GWL_EXSTYLE);
+        if (exStyle == 0) {
+            return false;
+        }
+        r_opacity = 255;
+        COLORREF key = 0;
+        BYTE alpha = 255;
+        DWORD flags = 0;
+        if ((exStyle & WS_EX_LAYERED) && GetLayeredWindowAttributes((HWND)handle, &key, &alpha, &flags) && (flags & LWA_ALPHA)) {
+            r_opacity = alpha;
+        }
+        return true;
+    }
+
+    bool opacity_needs_layered() const override { return true; }
+
+    void apply_opacity(WindowOpacityUpdate* updates, size_t count) override {
+        // 分层窗口的整体透明度由DWM混合，不需要重新绘制，也不需要FRAMECHANGED。
+        // WS_EX_LAYERED由管理器经apply_styles加上（影子状态同步更新），这里只写透明度；
+        // 不是分层窗口时SetLayeredWindowAttributes失败。恢复到255时保留LAYERED，之后的渐变不用再切换样式
+        for (size_t i = 0; i < count; i++) {
+            WindowOpacityUpdate& update = updates[i];
+            update.ok = SetLayeredWindowAttributes((HWND)update.handle, 0, update.opacity, LWA_ALPHA) != 0;
+        }
+    }
+
+    void process_pending_messages() override {
+        // PM_NOREMOVE不取出投递的消息，只处理其他线程用SendMessage同步发来的消息
+        MSG msg;
+        PeekMessage(&msg, NULL, 0, 0, PM_NOREMOVE);
+    }
+
+    bool set_show_hook(WindowShowHook hook, void* userdata) override {
+        return set_win32_show_hook(this, hook, userdata);
+    }
+
+    bool watch_style_changes(NativeWindowHandle handle, bool enabled) override {
+        return handle != 0 && set_win32_style_watch(this, (HWND)handle, enabled);
+    }
+
+    size_t poll_style_changes(std::vector<NativeWindowHandle>& r_handles) override {
+        Win32StyleWatch* watch = find_win32_style_watch(this);
+        if (!watch) {
+            return 0;
+        }
+        size_t count = 0;
+        for (HWND hwnd : watch->changed) {
+            if (std::find(r_handles.begin(), r_handles.end(), (NativeWindowHandle)hwnd) == r_handles.end()) {
+                r_handles.push_back((NativeWindowHandle)hwnd);
+                count++;
+            }
+        }
+        watch->changed.clear();
+        return count;
+    }
+
+private:
+    std::vector<char> region_buffer;
+
+    static BOOL CALLBACK find_main_window_proc(HWND hwnd, LPARAM lParam) {
+        // 检查是否为可见的顶层窗口
+        if (IsWindowVisible(hwnd) && GetParent(hwnd) == NULL) {
+            // 检查窗口样式，寻找主窗口特征
+            LONG style = GetWindowLong(hwnd, GWL_STYLE);
+            if ((style & WS_CAPTION) && (style & WS_SYSMENU)) {
+                // 找到可能的主窗口，保存句柄并停止枚举
+                *((HWND*)lParam) = hwnd;
+                return FALSE;
+            }
+        }
+        return TRUE; // 继续枚举
+    }
+
+    static HWND find_thread_main_window(DWORD thread_id) {
+        HWND found_hwnd = NULL;
+        EnumThreadWindows(thread_id, find_main_window_proc, (LPARAM)&found_hwnd);
+        return found_hwnd;
+    }
+};
+
+std::unique_ptr<WindowBackend> create_win32_window_backend() {
+    return std::unique_ptr<WindowBackend>(new Win32WindowBackend());
+}
+
+#endif // _WIN32
@@ -0,0 +1,568 @@
+#ifdef HIDE_TASKBAR_X11
+
+#include "window_backend.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/shape.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// _NET_WM_STATE客户端消息的操作码（EWMH规范）
+static const long NET_WM_STATE_REMOVE = 0;
+static const long NET_WM_STATE_ADD = 1;
+
+// X11错误处理是进程级的，这里只吞掉本后端连接上的错误（例如窗口已销毁导致的BadWindow），
+// 并计入该连接的错误计数与出错的资源ID；其他连接（包括Godot自己的）交给之前的处理函数。
+// 第一个连接打开时安装处理函数，最后一个连接关闭时还原。
+struct X11BackendConnection {
+    Display* display;
+    unsigned long* error_count;
+    std::vector<XID>* failed_resources;
+};
+
+static std::mutex x11_connections_mutex;
+static std::vector<X11BackendConnection> x11_connections;
+static XErrorHandler x11_previous_error_handler = nullptr;
+
+static int x11_backend_error_handler(Display* display, XErrorEvent* event) {
+    {
+        std::lock_guard<std::mutex> lock(x11_connections_mutex);
+        for (const X11BackendConnection& connection : x11_connections) {
+            if (connection.display == display) {
+                (*connection.error_count)++;
+                connection.failed_resources->push_back(event->resourceid);
+                return 0;
+            }
+        }
+    }
+    return x11_previous_error_handler ? x11_previous_error_handler(display, event) : 0;
+}
+
+static void x11_add_connection(Display* display, unsigned long* error_count, std::vector<XID>* failed_resources) {
+    std::lock_guard<std::mutex> lock(x11_connections_mutex);
+    if (x11_connections.empty()) {
+        x11_previous_error_handler = XSetErrorHandler(x11_backend_error_handler);
+    }
+    x11_connections.push_back({ display, error_count, failed_resources });
+}
+
+static void x11_remove_connection(Display* display) {
+    std::lock_guard<std::mutex> lock(x11_connections_mutex);
+    for (size_t i = 0; i < x11_connections.size(); i++) {
+        if (x11_connections[i].display == display) {
+            x11_connections.erase(x11_connections.begin() + i);
+            break;
+        }
+    }
+    if (!x11_connections.empty()) {
+        return;
+    }
+    // 之后又有人替换了处理函数时保留对方的（它可能链回本函数，此时列表为空会直接转交）
+    XErrorHandler current = XSetErrorHandler(x11_previous_error_handler);
+    if (current != x11_backend_error_handler) {
+        XSetErrorHandler(current);
+    }
+}
+
+// X11后端
+// 任务栏：_NET_WM_STATE_SKIP_TASKBAR + _NET_WM_STATE_SKIP_PAGER（对应TOOL_WINDOW）。
+// 鼠标穿透：XShape输入区域设为空（对应LAYERED | TRANSPARENT）。
+// 外部样式变化：在本后端的连接上选择PropertyNotify（_NET_WM_STATE）与ShapeNotify（输入区域），每帧不阻塞地取回。
+// 映射状态与_NET_WM_STATE按窗口缓存：首次使用时查询一次，之后由StructureNotify/PropertyNotify事件更新，
+// 提交样式时只发送请求不等待回复。
+// 不透明度：_NET_WM_WINDOW_OPACITY（由合成器混合，没有合成器时不生效），255时删除该属性。
+// 使用独立的Display连接，不干扰Godot的连接；一批变更只在最后XFlush一次。
+// 连接可能同时被主线程与异步执行器使用，所有访问都加锁（不依赖XInitThreads）。
+class X11WindowBackend : public WindowBackend {
+public:
+    ~X11WindowBackend() override {
+        if (display) {
+            XCloseDisplay(display);
+            x11_remove_connection(display);
+        }
+    }
+
+    const char* get_name() const override { return "x11"; }
+
+    bool is_supported() const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return const_cast<X11WindowBackend*>(this)->ensure_display();
+    }
+
+    bool read_style(NativeWindowHandle handle, uint32_t& r_style) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!handle || !ensure_display()) {
+            return false;
+        }
+        Window window = (Window)handle;
+
+        // 读取_NET_WM_STATE中是否有SKIP_TASKBAR
+        Atom type = None;
+        int format = 0;
+        unsigned long count = 0;
+        unsigned long remaining = 0;
+        unsigned char* data = nullptr;
+        if (XGetWindowProperty(display, window, atom_wm_state, 0, 64, False, XA_ATOM,
+                               &type, &format, &count, &remaining, &data) != Success) {
+            return false;
+        }
+
+        bool skip_taskbar = false;
+        if (data && type == XA_ATOM && format == 32) {
+            Atom* atoms = (Atom*)data;
+            for (unsigned long i = 0; i < count; i++) {
+                if (atoms[i] == atom_skip_taskbar) {
+                    skip_taskbar = true;
+                }
+            }
+        }
+        if (data) {
+            XFree(data);
+        }
+
+        uint32_t style = skip_taskbar ? WINDOW_STYLE_TOOL_WINDOW : WINDOW_STYLE_APP_WINDOW;
+
+        // 输入区域为空即为鼠标穿透
+        if (has_shape) {
+            int rect_count = 0;
+            int ordering = 0;
+            // 空区域与失败都返回NULL，失败时错误在等待回复期间已交给处理函数计数
+            unsigned long errors = error_count;
+            XRectangle* rects = XShapeGetRectangles(display, window, ShapeInput, &rect_count, &ordering);
+            if (rects) {
+                XFree(rects);
+            } else if (error_count != errors) {
+                return false;
+            }
+            if (rect_count == 0) {
+                style |= WINDOW_STYLE_CLICK_THROUGH_MASK;
+            }
+        }
+        r_style = style;
+        return true;
+    }
+
+    void apply_styles(WindowStyleUpdate* updates, size_t count) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ensure_display()) {
+            for (size_t i = 0; i < count; i++) {
+                updates[i].ok = false;
+            }
+            return;
+        }
+
+        // 先处理已到达的事件，使缓存的映射状态与_NET_WM_STATE是最新的
+        process_events();
+        failed_resources.clear();
+        unsigned long errors = error_count;
+
+        // 发给窗口本身的请求（直接改写属性、XShape）在窗口已销毁时会异步报错，
+        // 发给根窗口的_NET_WM_STATE消息不会
+        bool needs_sync = false;
+        for (size_t i = 0; i < count; i++) {
+            WindowStyleUpdate& update = updates[i];
+            Window window = (Window)update.handle;
+            uint32_t changed = update.old_style ^ update.new_style;
+
+            update.ok = true;
+            if (changed & WINDOW_STYLE_TASKBAR_MASK) {
+                bool direct_write = false;
+                update.ok = set_skip_taskbar(window, (update.new_style & WINDOW_STYLE_TOOL_WINDOW) != 0, direct_write);
+                needs_sync = needs_sync || direct_write;
+            }
+            if (changed & WINDOW_STYLE_CLICK_THROUGH_MASK) {
+                // 没有XShape扩展时无法实现穿透
+                update.ok = update.ok && has_shape;
+                set_click_through(window, (update.new_style & WINDOW_STYLE_CLICK_THROUGH_MASK) == WINDOW_STYLE_CLICK_THROUGH_MASK);
+                needs_sync = needs_sync || has_shape;
+            }
+        }
+
+        if (!needs_sync) {
+            // 整批请求只发送一次
+            XFlush(display);
+            return;
+        }
+
+        // 整批只等待一次，确认窗口本身的请求没有出错（与read_style相同，按错误计数判断）
+        XSync(display, False);
+        if (error_count == errors) {
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            WindowStyleUpdate& update = updates[i];
+            Window window = (Window)update.handle;
+            if (std::find(failed_resources.begin(), failed_resources.end(), (XID)window) != failed_resources.end()) {
+                update.ok = false;
+                window_states.erase(window);
+            }
+        }
+    }
+
+    bool set_input_region(NativeWindowHandle handle, const MaskRect* rects, size_t count) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!handle || !ensure_display() || !has_shape) {
+            return false;
+        }
+
+        // XRectangle使用16位坐标，超出部分裁掉
+        region_buffer.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            region_buffer[i].x = (short)std::min(rects[i].x, 32767);
+            region_buffer[i].y = (short)std::min(rects[i].y, 32767);
+            region_buffer[i].width = (unsigned short)std::min(rects[i].width, 65535);
+            region_buffer[i].height = (unsigned short)std::min(rects[i].height, 65535);
+        }
+        XShapeCombineRectangles(display, (Window)handle, ShapeInput, 0, 0,
+                                region_buffer.data(), (int)count, ShapeSet, Unsorted);
+        XFlush(display);
+        return true;
+    }
+
+    bool clear_input_region(NativeWindowHandle handle) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!handle || !ensure_display() || !has_shape) {
+            return false;
+        }
+        XShapeCombineMask(display, (Window)handle, ShapeInput, 0, 0, None, ShapeSet);
+        XFlush(display);
+        return true;
+    }
+
+    bool get_cursor_position(NativeWindowHandle handle, int32_t& r_x, int32_t& r_y) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!handle || !ensure_display()) {
+            return false;
+        }
+        // 输入区域为空时窗口收不到指针事件，但仍可以查询相对位置
+        Window pointer_root = 0;
+        Window child = 0;
+        int root_x = 0;
+        int root_y = 0;
+        int window_x = 0;
+        int window_y = 0;
+        unsigned int mask = 0;
+        if (!XQueryPointer(display, (Window)handle, &pointer_root, &child, &root_x, &root_y, &window_x, &window_y, &mask)) {
+            return false; // 指针在另一个屏幕上
+        }
+        r_x = window_x;
+        r_y = window_y;
+        return true;
+    }
+
+    bool read_opacity(NativeWindowHandle handle, uint8_t& r_opacity) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!handle || !ensure_display()) {
+            return false;
+        }
+
+        Atom type = None;
+        int format = 0;
+        unsigned long count = 0;
+        unsigned long remaining = 0;
+        unsigned char* data = nullptr;
+        if (XGetWindowProperty(display, (Window)handle, atom_opacity, 0, 1, False, XA_CARDINAL,
+                               &type, &format, &count, &remaining, &data) != Success) {
+            return false;
+        }
+
+        // 格式32的属性在客户端以long保存，取最高8位
+        r_opacity = 255;
+        if (data && type == XA_CARDINAL && format == 32 && count == 1) {
+            r_opacity = (uint8_t)((*(unsigned long*)data >> 24) & 0xff);
+        }
+        if (data) {
+            XFree(data);
+        }
+        return true;
+    }
+
+    void apply_opacity(WindowOpacityUpdate* updates, size_t count) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ensure_display()) {
+            for (size_t i = 0; i < count; i++) {
+                updates[i].ok = false;
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            WindowOpacityUpdate& update = updates[i];
+            Window window = (Window)update.handle;
+            if (update.opacity == 255) {
+                XDeleteProperty(display, window, atom_opacity);
+            } else {
+                unsigned long value = (unsigned long)update.opacity * 0x01010101ul;
+                XChangeProperty(display, window, atom_opacity, XA_CARDINAL, 32, PropModeReplace,
+                                (unsigned char*)&value, 1);
+            }
+            update.ok = true;
+        }
+
+        // 整批请求只发送一次
+        XFlush(display);
+    }
+
+    bool watch_style_changes(NativeWindowHandle handle, bool enabled) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!handle || !ensure_display()) {
+            return false;
+        }
+        // 事件掩码按连接记录，不影响Godot自己的连接；StructureNotify与PropertyChange同时维护缓存，关闭监视后仍保留
+        X11WindowState& state = track_window((Window)handle);
+        state.watched = enabled;
+        if (has_shape) {
+            XShapeSelectInput(display, (Window)handle, enabled ? ShapeNotifyMask : 0);
+        }
+        XFlush(display);
+        return true;
+    }
+
+    size_t poll_style_changes(std::vector<NativeWindowHandle>& r_handles) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!display) {
+            return 0;
+        }
+
+        process_events();
+        // 出错的资源ID只在apply_styles的一批内使用，其他调用留下的记录每帧丢弃
+        failed_resources.clear();
+        size_t count = 0;
+        for (Window window : changed_windows) {
+            if (std::find(r_handles.begin(), r_handles.end(), (NativeWindowHandle)window) == r_handles.end()) {
+                r_handles.push_back((NativeWindowHandle)window);
+                count++;
+            }
+        }
+        changed_windows.clear();
+        return count;
+    }
+
+private:
+    // 本连接上已选择事件的窗口
+    struct X11WindowState {
+        bool watched = false; // 向管理器报告外部变化
+        bool mapped = false;
+        bool mapped_known = false;
+        bool states_known = false;
+        int pending_state_writes = 0; // 自己直接改写_NET_WM_STATE后尚未收到的PropertyNotify
+        std::vector<Atom> states;     // 缓存的_NET_WM_STATE
+    };
+
+    Display* display = nullptr;
+    bool display_failed = false;
+    unsigned long error_count = 0;       // 由错误处理函数在持有mutex的调用中累加
+    std::vector<XID> failed_resources;   // 同上，出错请求的资源ID
+    std::unordered_map<Window, X11WindowState> window_states;
+    std::vector<Window> changed_windows; // 已取回、尚未报告的外部变化
+    bool has_shape = false;
+    int shape_event_base = 0;
+    bool has_wm = false;
+    Window root = 0;
+    std::vector<XRectangle> region_buffer;
+    mutable std::mutex mutex;
+
+    Atom atom_wm_state = None;
+    Atom atom_skip_taskbar = None;
+    Atom atom_skip_pager = None;
+    Atom atom_opacity = None;
+
+    bool ensure_display() {
+        if (display) {
+            return true;
+        }
+        if (display_failed) {
+            return false;
+        }
+
+        display = XOpenDisplay(nullptr);
+        if (!display) {
+            display_failed = true;
+            return false;
+        }
+
+        int shape_error = 0;
+        has_shape = XShapeQueryExtension(display, &shape_event_base, &shape_error);
+
+        x11_add_connection(display, &error_count, &failed_resources);
+
+        // 一次往返取得所有原子
+        const char* names[] = {
+            "_NET_WM_STATE",
+            "_NET_WM_STATE_SKIP_TASKBAR",
+            "_NET_WM_STATE_SKIP_PAGER",
+            "_NET_SUPPORTING_WM_CHECK",
+            "_NET_WM_WINDOW_OPACITY",
+        };
+        Atom atoms[5];
+        XInternAtoms(display, (char**)names, 5, False, atoms);
+        atom_wm_state = atoms[0];
+        atom_skip_taskbar = atoms[1];
+        atom_skip_pager = atoms[2];
+        atom_opacity = atoms[4];
+
+        root = DefaultRootWindow(display);
+        has_wm = has_window_property(root, atoms[3]);
+        return true;
+    }
+
+    bool has_window_property(Window window, Atom property) {
+        Atom type = None;
+        int format = 0;
+        unsigned long count = 0;
+        unsigned long remaining = 0;
+        unsigned char* data = nullptr;
+        int status = XGetWindowProperty(display, window, property, 0, 1, False, AnyPropertyType,
+                                        &type, &format, &count, &remaining, &data);
+        if (data) {
+            XFree(data);
+        }
+        return status == Success && count > 0;
+    }
+
+    // 第一次使用窗口时选择事件，之后映射状态与_NET_WM_STATE的变化都会到达本连接
+    X11WindowState& track_window(Window window) {
+        auto it = window_states.find(window);
+        if (it != window_states.end()) {
+            return it->second;
+        }
+        XSelectInput(display, window, StructureNotifyMask | PropertyChangeMask);
+        return window_states[window];
+    }
+
+    // 不等待地取回已到达的事件，更新缓存并记录被监视窗口的外部变化
+    void process_events() {
+        // XPending只读取已经到达的事件，不等待
+        while (XPending(display) > 0) {
+            XEvent event;
+            XNextEvent(display, &event);
+
+            Window window = 0;
+            if (event.type == MapNotify || event.type == UnmapNotify) {
+                Window target = event.type == MapNotify ? event.xmap.window : event.xunmap.window;
+                auto it = window_states.find(target);
+                if (it != window_states.end()) {
+                    it->second.mapped = event.type == MapNotify;
+                    it->second.mapped_known = true;
+                }
+            } else if (event.type == DestroyNotify) {
+                window_states.erase(event.xdestroywindow.window);
+            } else if (event.type == PropertyNotify && event.xproperty.atom == atom_wm_state) {
+                auto it = window_states.find(event.xproperty.window);
+                if (it != window_states.end()) {
+                    X11WindowState& state = it->second;
+                    // 自己的写入已经反映在缓存里；其他客户端（窗口管理器）的修改要在下次直接改写前重新读取
+                    if (state.pending_state_writes > 0) {
+                        state.pending_state_writes--;
+                    } else {
+                        state.states_known = false;
+                    }
+                    if (state.watched) {
+                        window = event.xproperty.window;
+                    }
+                }
+            } else if (has_shape && event.type == shape_event_base + ShapeNotify) {
+                const XShapeEvent* shape = (const XShapeEvent*)&event;
+                auto it = window_states.find(shape->window);
+                if (shape->kind == ShapeInput && it != window_states.end() && it->second.watched) {
+                    window = shape->window;
+                }
+            }
+            if (window) {
+                changed_windows.push_back(window);
+            }
+        }
+    }
+
+    // r_direct_write：是否直接改写了窗口属性（窗口已销毁时会异步报错）
+    bool set_skip_taskbar(Window window, bool skip, bool& r_direct_write) {
+        X11WindowState& state = track_window(window);
+
+        // EWMH：窗口管理器只处理已映射窗口的_NET_WM_STATE消息，未映射的窗口由客户端直接改写属性，
+        // 映射时窗口管理器会读取它。没有窗口管理器时不需要映射状态。
+        if (has_wm && !state.mapped_known) {
+            // 只在第一次使用时查询（此时事件已选择，之后的变化由MapNotify/UnmapNotify更新）
+            XWindowAttributes attributes;
+            if (!XGetWindowAttributes(display, window, &attributes)) {
+                window_states.erase(window);
+                return false; // 窗口已销毁
+            }
+            state.mapped = attributes.map_state != IsUnmapped;
+            state.mapped_known = true;
+        }
+        if (has_wm && state.mapped) {
+            // 由窗口管理器修改_NET_WM_STATE：一条消息同时切换SKIP_TASKBAR与SKIP_PAGER
+            XEvent event = {};
+            event.xclient.type = ClientMessage;
+            event.xclient.window = window;
+            event.xclient.message_type = atom_wm_state;
+            event.xclient.format = 32;
+            event.xclient.data.l[0] = skip ? NET_WM_STATE_ADD : NET_WM_STATE_REMOVE;
+            event.xclient.data.l[1] = (long)atom_skip_taskbar;
+            event.xclient.data.l[2] = (long)atom_skip_pager;
+            event.xclient.data.l[3] = 1; // 来源：普通应用
+            XSendEvent(display, root, False, SubstructureRedirectMask | SubstructureNotifyMask, &event);
+            return true;
+        }
+
+        // 没有窗口管理器或窗口未映射时直接改写属性，其他状态取自缓存
+        if (!state.states_known) {
+            state.states.clear();
+            Atom type = None;
+            int format = 0;
+            unsigned long count = 0;
+            unsigned long remaining = 0;
+            unsigned char* data = nullptr;
+            if (XGetWindowProperty(display, window, atom_wm_state, 0, 64, False, XA_ATOM,
+                                   &type, &format, &count, &remaining, &data) == Success && data) {
+                if (type == XA_ATOM && format == 32) {
+                    Atom* atoms = (Atom*)data;
+                    state.states.assign(atoms, atoms + count);
+                }
+            }
+            if (data) {
+                XFree(data);
+            }
+            state.states_known = true;
+        }
+
+        std::vector<Atom>& states = state.states;
+        states.erase(std::remove_if(states.begin(), states.end(), [this](Atom atom) {
+            return atom == atom_skip_taskbar || atom == atom_skip_pager;
+        }), states.end());
+        if (skip) {
+            states.push_back(atom_skip_taskbar);
+            states.push_back(atom_skip_pager);
+        }
+        XChangeProperty(display, window, atom_wm_state, XA_ATOM, 32, PropModeReplace,
+                        (unsigned char*)states.data(), (int)states.size());
+        state.pending_state_writes++;
+        r_direct_write = true;
+        return true;
+    }
+
+    void set_click_through(Window window, bool click_through) {
+        if (!has_shape) {
+            return;
+        }
+
+        if (click_through) {
+            // 空输入区域：所有鼠标事件穿透到下面的窗口
+            XShapeCombineRectangles(display, window, ShapeInput, 0, 0, nullptr, 0, ShapeSet, Unsorted);
+        } else {
+            // 恢复默认输入区域（整个窗口）
+            XShapeCombineMask(display, window, ShapeInput, 0, 0, None, ShapeSet);
+        }
+    }
+};
+
+std::unique_ptr<WindowBackend> create_x11_window_backend() {
+    return std::unique_ptr<WindowBackend>(new X11WindowBackend());
+}
+
+#endif // HIDE_TASKBAR_X11
@@ -0,0 +1,133 @@
+#include "window_executor.h"
+#include "trace.h"
+
+#include <chrono>
+
+// 一次最多合并的命令数量，避免执行线程长时间不写回结果
+static const size_t MAX_COMMANDS_PER_BATCH = 256;
+
+WindowExecutor::WindowExecutor(WindowStyleManager& p_manager, std::recursive_mutex& p_manager_mutex) :
+        manager(p_manager), manager_mutex(p_manager_mutex) {
+}
+
+WindowExecutor::~WindowExecutor() {
+    stop();
+}
+
+void WindowExecutor::start() {
+    if (thread.joinable()) {
+        return;
+    }
+    stopping = false;
+    finished = false;
+    thread = std::thread(&WindowExecutor::run, this);
+}
+
+void WindowExecutor::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+
+    // Win32下执行线程写入样式时会同步等待窗口线程（主线程）处理消息，
+    // 等待期间继续处理这些消息，否则两个线程互相等待
+    while (!finished.load()) {
+        manager.get_backend()->process_pending_messages();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    thread.join();
+}
+
+uint64_t WindowExecutor::submit(uint32_t window_id, uint64_t owner_id, const WindowStyleRequest& request) {
+    WindowCommand command;
+    command.request_id = next_request_id.fetch_add(1);
+    command.window_id = window_id;
+    command.owner_id = owner_id;
+    command.request = request;
+    commands.push(command);
+
+    // 先增加计数再检查休眠标志，执行线程休眠前会再检查一次计数，不会漏掉唤醒
+    pending.fetch_add(1);
+    if (sleeping.load()) {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        wake.notify_one();
+    }
+    return command.request_id;
+}
+
+bool WindowExecutor::poll_result(WindowCommandResult& r_result) {
+    return results.pop(r_result);
+}
+
+void WindowExecutor::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            sleeping = true;
+            wake.wait(lock, [this]() { return pending.load() > 0 || stopping.load(); });
+            sleeping = false;
+        }
+
+        // 生产者刚交换完头指针时pop会暂时失败，计数保证稍后还会再取
+        drained.clear();
+        WindowCommand command;
+        while (drained.size() < MAX_COMMANDS_PER_BATCH && commands.pop(command)) {
+            drained.push_back(command);
+        }
+
+        if (drained.empty()) {
+            if (stopping.load() && pending.load() <= 0) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        pending.fetch_sub((int64_t)drained.size());
+        execute(drained);
+    }
+    finished = true;
+}
+
+void WindowExecutor::execute(const std::vector<WindowCommand>& p_commands) {
+    WindowBackend* backend = nullptr;
+    {
+        // 解析句柄并合并同一窗口的命令，计算需要写入的变更
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        batch.clear();
+        slots.clear();
+        for (const WindowCommand& command : p_commands) {
+            WindowRecord* record = manager.resolve(command.window_id, command.owner_id);
+            slots.push_back(batch.add(record, command.request));
+        }
+        manager.prepare(batch.get_records(), batch.get_requests(), batch.size(), plan);
+        backend = manager.get_backend();
+    }
+
+    // 系统调用期间不持有锁
+    WindowStyleManager::submit(backend, plan);
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        manager.finish(plan);
+    }
+
+    // 合并后同一窗口的命令共用一个结果
+    for (size_t i = 0; i < p_commands.size(); i++) {
+        WindowCommandResult result;
+        result.request_id = p_commands[i].request_id;
+        result.window_id = p_commands[i].window_id;
+        result.owner_id = p_commands[i].owner_id;
+        result.request = p_commands[i].request;
+        result.ok = slots[i] != WindowStyleBatch::INVALID_INDEX && plan.ok[slots[i]];
+        if (!result.ok) {
+            HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_ASYNC, result.window_id, false, "Async window operation failed");
+        }
+        results.push(result);
+    }
+    completed.fetch_add(p_commands.size());
+}
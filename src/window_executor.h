@@ -0,0 +1,81 @@
+#ifndef WINDOW_EXECUTOR_H
+#define WINDOW_EXECUTOR_H
+
+#include "mpsc_queue.h"
+#include "window_style_manager.h"
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 一条异步样式变更
+struct WindowCommand {
+    uint64_t request_id = 0;
+    uint32_t window_id = 0;
+    uint64_t owner_id = 0;
+    WindowStyleRequest request;
+};
+
+// 异步变更的结果，ok表示样式已经写入（窗口的隐藏/显示可能仍在窗口线程的消息队列中）
+struct WindowCommandResult {
+    uint64_t request_id = 0;
+    uint32_t window_id = 0;
+    uint64_t owner_id = 0;
+    WindowStyleRequest request;
+    bool ok = false;
+};
+
+// 异步执行器：任意线程通过无锁队列提交样式变更，由专用线程按批次执行，
+// 结果放入另一个无锁队列，由主线程取回。
+// 执行线程只在计算变更和写回影子状态时持有manager_mutex，调用后端时不持有，
+// 因此主线程上的查询不会等待系统调用。
+class WindowExecutor {
+public:
+    WindowExecutor(WindowStyleManager& p_manager, std::recursive_mutex& p_manager_mutex);
+    ~WindowExecutor();
+
+    void start();
+    // 执行完已提交的命令后停止（在主线程调用）
+    void stop();
+    bool is_running() const { return thread.joinable(); }
+
+    // 任意线程调用，返回请求ID（从1开始递增）
+    uint64_t submit(uint32_t window_id, uint64_t owner_id, const WindowStyleRequest& request);
+    // 取回一条结果，只能在一个线程（主线程）调用
+    bool poll_result(WindowCommandResult& r_result);
+
+    uint64_t get_submitted() const { return next_request_id.load() - 1; }
+    uint64_t get_completed() const { return completed.load(); }
+
+private:
+    void run();
+    void execute(const std::vector<WindowCommand>& commands);
+
+    WindowStyleManager& manager;
+    std::recursive_mutex& manager_mutex;
+
+    MpscQueue<WindowCommand> commands;
+    MpscQueue<WindowCommandResult> results;
+    std::atomic<uint64_t> next_request_id{ 1 };
+    std::atomic<int64_t> pending{ 0 };  // 生产者先入队后计数，可能短暂为负
+    std::atomic<uint64_t> completed{ 0 };
+
+    // 队列为空时执行线程休眠，生产者只在它休眠时才加锁唤醒
+    std::thread thread;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::atomic<bool> sleeping{ false };
+    std::atomic<bool> stopping{ false };
+    std::atomic<bool> finished{ false };
+
+    // 执行线程复用的缓冲区
+    std::vector<WindowCommand> drained;
+    std::vector<size_t> slots;
+    WindowStyleBatch batch;
+    WindowStylePlan plan;
+};
+
+#endif // WINDOW_EXECUTOR_H
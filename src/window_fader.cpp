@@ -0,0 +1,196 @@
+#include "window_fader.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+WindowFader::WindowFader(WindowStyleManager& p_manager, std::recursive_mutex& p_manager_mutex) :
+        manager(p_manager), manager_mutex(p_manager_mutex) {
+}
+
+WindowFader::~WindowFader() {
+    stop();
+}
+
+int64_t WindowFader::now_usec() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void WindowFader::fade(uint32_t window_id, uint64_t owner_id, uint8_t target, int64_t duration_usec) {
+    {
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        cancel(owner_id);
+
+        ActiveFade fade;
+        fade.window_id = window_id;
+        fade.owner_id = owner_id;
+        fade.target = target;
+        fade.start_usec = now_usec();
+        fade.duration_usec = std::max<int64_t>(duration_usec, 0);
+        fade.generation = next_generation++;
+        fades.push_back(fade);
+        active = fades.size();
+    }
+
+    // 先持有wake_mutex再通知，线程不会错过刚加入的渐变
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+    }
+    wake.notify_one();
+}
+
+bool WindowFader::cancel(uint64_t owner_id) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    for (size_t i = 0; i < fades.size(); i++) {
+        if (fades[i].owner_id == owner_id) {
+            finish_fade(i, false, true);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WindowFader::clear() {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    fades.clear();
+    active = 0;
+}
+
+size_t WindowFader::get_fade_count() const {
+    return active.load();
+}
+
+void WindowFader::set_interval_ms(int p_interval_ms) {
+    interval_ms = std::max(1, p_interval_ms);
+    wake.notify_one();
+}
+
+void WindowFader::start() {
+    if (thread.joinable()) {
+        return;
+    }
+    stopping = false;
+    finished = false;
+    thread = std::thread(&WindowFader::run, this);
+}
+
+void WindowFader::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+
+    // 与异步执行器相同：后端调用可能同步等待窗口线程
+    while (!finished.load()) {
+        manager.get_backend()->process_pending_messages();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    thread.join();
+}
+
+bool WindowFader::poll_event(FadeEvent& r_event) {
+    return events.pop(r_event);
+}
+
+void WindowFader::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            if (active.load() == 0) {
+                wake.wait(lock, [this]() { return stopping.load() || active.load() > 0; });
+            } else {
+                wake.wait_for(lock, std::chrono::milliseconds(interval_ms.load()), [this]() { return stopping.load(); });
+            }
+        }
+        if (stopping.load()) {
+            break;
+        }
+        tick();
+    }
+    finished = true;
+}
+
+void WindowFader::finish_fade(size_t index, bool completed, bool ok) {
+    // 调用时持有manager_mutex
+    const ActiveFade& fade = fades[index];
+    FadeEvent event;
+    event.window_id = fade.window_id;
+    event.owner_id = fade.owner_id;
+    event.completed = completed;
+    event.ok = ok;
+    events.push(event);
+
+    fades[index] = fades.back();
+    fades.pop_back();
+    active = fades.size();
+}
+
+int WindowFader::tick() {
+    int64_t now = now_usec();
+    WindowBackend* backend = nullptr;
+    {
+        // 解析句柄并计算本次的不透明度，插值起点在第一次检查时确定
+        std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+        steps.clear();
+        records.clear();
+        values.clear();
+        for (ActiveFade& fade : fades) {
+            WindowRecord* record = manager.resolve(fade.window_id, fade.owner_id);
+            if (record && fade.from < 0 && manager.load_opacity(*record)) {
+                fade.from = record->opacity;
+            }
+
+            double t = 1.0;
+            if (fade.duration_usec > 0) {
+                t = std::min(std::max((double)(now - fade.start_usec) / (double)fade.duration_usec, 0.0), 1.0);
+            }
+            int from = fade.from < 0 ? fade.target : fade.from;
+            int value = (int)std::lround(from + (fade.target - from) * t);
+
+            Step step;
+            step.owner_id = fade.owner_id;
+            step.generation = fade.generation;
+            step.done = t >= 1.0;
+            steps.push_back(step);
+            records.push_back(record);
+            values.push_back((uint8_t)value);
+        }
+        if (steps.empty()) {
+            return 0;
+        }
+        // 与当前值相同的窗口不会写入系统
+        manager.prepare_opacity(records.data(), values.data(), records.size(), plan);
+        backend = manager.get_backend();
+    }
+
+    // 系统调用期间不持有锁
+    WindowStyleManager::submit_opacity(backend, plan);
+
+    int count = 0;
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex);
+    manager.finish_opacity(plan);
+    for (size_t i = 0; i < steps.size(); i++) {
+        bool ok = plan.ok[i] != 0;
+        if (!steps[i].done && ok) {
+            continue;
+        }
+        // 检查期间渐变被替换或取消时丢弃结果
+        for (size_t k = 0; k < fades.size(); k++) {
+            if (fades[k].owner_id == steps[i].owner_id && fades[k].generation == steps[i].generation) {
+                if (!ok) {
+                    HIDE_TASKBAR_TRACE(TRACE_LEVEL_WARNING, TRACE_OP_OPACITY, fades[k].window_id, false, "Failed to apply fade opacity");
+                }
+                finish_fade(k, ok, ok);
+                count++;
+                break;
+            }
+        }
+    }
+    return count;
+}
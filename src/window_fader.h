@@ -0,0 +1,101 @@
+#ifndef WINDOW_FADER_H
+#define WINDOW_FADER_H
+
+#include "mpsc_queue.h"
+#include "window_style_manager.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 渐变结束：completed为false表示被替换、取消或写入失败（ok为false）
+struct FadeEvent {
+    uint32_t window_id = 0;
+    uint64_t owner_id = 0;
+    bool completed = false;
+    bool ok = false;
+};
+
+// 不透明度渐变：专用线程按固定间隔（默认约60Hz）线性插值，通过后端改写窗口整体不透明度，
+// 不重新绘制窗口内容；同一次检查中所有窗口的变化合并为一批。没有渐变时线程休眠，不占用CPU。
+// 与悬停跟踪相同，只在解析句柄和写回影子状态时持有manager_mutex，调用后端时不持有；
+// 结束事件放入无锁队列，由主线程取回后发出信号。
+class WindowFader {
+public:
+    static const int DEFAULT_INTERVAL_MS = 16;
+
+    WindowFader(WindowStyleManager& p_manager, std::recursive_mutex& p_manager_mutex);
+    ~WindowFader();
+
+    // 从当前不透明度渐变到target，duration_usec <= 0时下一次检查直接写入目标值；
+    // 同一窗口正在进行的渐变被替换（发出completed为false的事件）
+    void fade(uint32_t window_id, uint64_t owner_id, uint8_t target, int64_t duration_usec);
+    // 停止渐变并保持当前不透明度，发出completed为false的事件
+    bool cancel(uint64_t owner_id);
+    void clear();
+    size_t get_fade_count() const;
+
+    void set_interval_ms(int interval_ms);
+    int get_interval_ms() const { return interval_ms.load(); }
+
+    // stop在主线程调用
+    void start();
+    void stop();
+    bool is_running() const { return thread.joinable(); }
+
+    // 推进一次所有渐变（渐变线程调用，也可以在测试中直接调用），返回结束的渐变数
+    int tick();
+
+    // 取回一条结束事件，只能在一个线程（主线程）调用
+    bool poll_event(FadeEvent& r_event);
+
+private:
+    struct ActiveFade {
+        uint32_t window_id = 0;
+        uint64_t owner_id = 0;
+        int from = -1; // 第一次检查时取当前不透明度
+        uint8_t target = 255;
+        int64_t start_usec = 0;
+        int64_t duration_usec = 0;
+        uint64_t generation = 0;
+    };
+
+    // 一次检查中的渐变快照
+    struct Step {
+        uint64_t owner_id = 0;
+        uint64_t generation = 0;
+        bool done = false;
+    };
+
+    static int64_t now_usec();
+    void run();
+    void finish_fade(size_t index, bool completed, bool ok);
+
+    WindowStyleManager& manager;
+    std::recursive_mutex& manager_mutex;
+
+    // 渐变列表由manager_mutex保护
+    std::vector<ActiveFade> fades;
+    uint64_t next_generation = 1;
+    std::atomic<size_t> active{ 0 };
+
+    MpscQueue<FadeEvent> events;
+    std::atomic<int> interval_ms{ DEFAULT_INTERVAL_MS };
+
+    std::thread thread;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{ false };
+    std::atomic<bool> finished{ false };
+
+    // 渐变线程复用的缓冲区
+    std::vector<Step> steps;
+    std::vector<WindowRecord*> records;
+    std::vector<uint8_t> values;
+    WindowOpacityPlan plan;
+};
+
+#endif // WINDOW_FADER_H
@@ -0,0 +1,71 @@
+#include "window_slot_table.h"
+
+// 代数只使用31位，ID始终为正数（GDScript的int）
+static const uint32_t GENERATION_MASK = 0x7FFFFFFFu;
+
+int64_t WindowSlotTable::make_id(uint32_t index, uint32_t generation) {
+    return ((int64_t)generation << 32) | (int64_t)index;
+}
+
+int64_t WindowSlotTable::add(uint64_t owner_id) {
+    uint32_t index = 0;
+    if (!free_slots.empty()) {
+        index = free_slots.back();
+        free_slots.pop_back();
+    } else {
+        index = (uint32_t)slots.size();
+        slots.push_back(WindowSlot());
+    }
+
+    WindowSlot& slot = slots[index];
+    slot.owner_id = owner_id;
+    slot.window_id = WindowSlot::NO_WINDOW;
+    slot.used = true;
+    used_count++;
+    return make_id(index, slot.generation);
+}
+
+bool WindowSlotTable::remove(int64_t id) {
+    WindowSlot* slot = get(id);
+    if (!slot) {
+        return false;
+    }
+
+    slot->used = false;
+    slot->owner_id = 0;
+    slot->window_id = WindowSlot::NO_WINDOW;
+    slot->generation = (slot->generation + 1) & GENERATION_MASK;
+    if (slot->generation == 0) {
+        slot->generation = 1;
+    }
+    free_slots.push_back((uint32_t)(id & 0xFFFFFFFF));
+    used_count--;
+    return true;
+}
+
+WindowSlot* WindowSlotTable::get(int64_t id) {
+    uint64_t index = (uint64_t)id & 0xFFFFFFFFu;
+    uint32_t generation = (uint32_t)((uint64_t)id >> 32);
+    if (id <= 0 || index >= slots.size()) {
+        return nullptr;
+    }
+    WindowSlot& slot = slots[index];
+    return slot.used && slot.generation == generation ? &slot : nullptr;
+}
+
+const WindowSlot* WindowSlotTable::get(int64_t id) const {
+    return const_cast<WindowSlotTable*>(this)->get(id);
+}
+
+void WindowSlotTable::clear() {
+    // 保留槽位与代数，清空前发出的ID之后仍然无效
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].used) {
+            remove(make_id((uint32_t)i, slots[i].generation));
+        }
+    }
+    free_slots.clear();
+    for (size_t i = slots.size(); i > 0; i--) {
+        free_slots.push_back((uint32_t)(i - 1));
+    }
+}
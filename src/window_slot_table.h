@@ -0,0 +1,42 @@
+#ifndef WINDOW_SLOT_TABLE_H
+#define WINDOW_SLOT_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 一个登记的窗口：所属对象ID + 最近一次解析到的窗口ID（原生窗口重建后由前端更新）
+struct WindowSlot {
+    static const uint32_t NO_WINDOW = 0xFFFFFFFFu;
+
+    uint64_t owner_id = 0;
+    uint32_t window_id = NO_WINDOW;
+    uint32_t generation = 1;
+    bool used = false;
+};
+
+// 脚本持有的窗口ID的槽位表。ID的低32位为槽位序号，高位为槽位的代数（从1开始，有效ID不会是0），
+// 槽位释放后复用时代数加一，旧ID不会指向新窗口。槽位连续存放，按ID查找只需一次下标与代数比较。
+// 不依赖Godot，调用方负责加锁。
+class WindowSlotTable {
+public:
+    static const int64_t INVALID_ID = 0;
+
+    int64_t add(uint64_t owner_id);
+    bool remove(int64_t id);
+    // ID无效（越界、已释放或代数不符）时返回nullptr
+    WindowSlot* get(int64_t id);
+    const WindowSlot* get(int64_t id) const;
+    void clear();
+
+    size_t size() const { return used_count; }
+
+private:
+    static int64_t make_id(uint32_t index, uint32_t generation);
+
+    std::vector<WindowSlot> slots;
+    std::vector<uint32_t> free_slots;
+    size_t used_count = 0;
+};
+
+#endif // WINDOW_SLOT_TABLE_H
@@ -0,0 +1,430 @@
+#include "window_style_manager.h"
+#include "op_stats.h"
+
+#include <chrono>
+
+void WindowStyleRequest::merge(const WindowStyleRequest& other) {
+    if (other.set_taskbar) {
+        set_taskbar = true;
+        taskbar_visible = other.taskbar_visible;
+    }
+    if (other.set_clickable) {
+        set_clickable = true;
+        clickable = other.clickable;
+        keep_layered = other.keep_layered;
+    }
+    if (other.restore) {
+        restore = true;
+        restore_style = other.restore_style;
+        restore_mask = other.restore_mask;
+    }
+}
+
+size_t WindowStyleBatch::add(WindowRecord* record, const WindowStyleRequest& request) {
+    if (!record) {
+        return INVALID_INDEX;
+    }
+
+    auto it = index.find(record);
+    if (it != index.end()) {
+        requests[it->second].merge(request);
+        return it->second;
+    }
+
+    size_t slot = records.size();
+    index[record] = slot;
+    records.push_back(record);
+    requests.push_back(request);
+    return slot;
+}
+
+void WindowStyleBatch::clear() {
+    records.clear();
+    requests.clear();
+    index.clear();
+}
+
+WindowStyleManager::WindowStyleManager() {
+    backend = create_default_window_backend();
+}
+
+void WindowStyleManager::set_backend(std::unique_ptr<WindowBackend> p_backend) {
+    // 句柄与影子状态都属于旧后端
+    clear();
+    pending.clear();
+    pending_index.clear();
+    backend = std::move(p_backend);
+    if (!backend) {
+        backend = create_null_window_backend();
+    }
+}
+
+void WindowStyleManager::set_handle_lookup(WindowHandleLookup p_lookup, void* p_userdata) {
+    lookup = p_lookup;
+    lookup_userdata = p_userdata;
+}
+
+// 句柄缓存
+WindowRecord* WindowStyleManager::resolve(uint32_t window_id, uint64_t owner_id, bool* r_inserted) {
+    if (r_inserted) {
+        *r_inserted = false;
+    }
+
+    auto it = records.find(window_id);
+    if (it != records.end() && it->second.owner_id == owner_id) {
+        cache_hits++;
+        stats_record_lookup(true);
+        return &it->second;
+    }
+    cache_misses++;
+    stats_record_lookup(false);
+
+    NativeWindowHandle handle = lookup ? lookup(window_id, lookup_userdata) : 0;
+    if (window_id == MAIN_WINDOW_ID && (handle == 0 || !backend->is_valid_window(handle))) {
+        handle = backend->find_main_window();
+    }
+    if (handle == 0) {
+        return nullptr;
+    }
+
+    // 同一窗口ID换了对象（窗口被重建），旧的影子状态一并丢弃
+    WindowRecord& record = records[window_id];
+    record = WindowRecord();
+    record.window_id = window_id;
+    record.owner_id = owner_id;
+    record.handle = handle;
+    if (r_inserted) {
+        *r_inserted = true;
+    }
+    return &record;
+}
+
+WindowRecord* WindowStyleManager::find(uint32_t window_id, uint64_t owner_id) {
+    auto it = records.find(window_id);
+    if (it != records.end() && it->second.owner_id == owner_id) {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+WindowRecord* WindowStyleManager::find_by_handle(NativeWindowHandle handle) {
+    for (auto& pair : records) {
+        if (pair.second.handle == handle) {
+            return &pair.second;
+        }
+    }
+    return nullptr;
+}
+
+NativeWindowHandle WindowStyleManager::lookup_handle(uint32_t window_id) const {
+    return lookup ? lookup(window_id, lookup_userdata) : 0;
+}
+
+void WindowStyleManager::invalidate(uint32_t window_id, uint64_t owner_id) {
+    auto it = records.find(window_id);
+    if (it != records.end() && it->second.owner_id == owner_id) {
+        records.erase(it);
+    }
+}
+
+void WindowStyleManager::clear() {
+    records.clear();
+    cache_hits = 0;
+    cache_misses = 0;
+}
+
+// 影子状态
+bool WindowStyleManager::load_style(WindowRecord& record) {
+    if (record.style_known) {
+        return true;
+    }
+
+    uint32_t style = 0;
+    if (!backend->read_style(record.handle, style)) {
+        return false;
+    }
+
+    record.style = style;
+    record.style_known = true;
+    return true;
+}
+
+bool WindowStyleManager::resync(WindowRecord& record) {
+    record.style_known = false;
+    return load_style(record);
+}
+
+void WindowStyleManager::resync_all() {
+    // 标记为未知，下次访问时重新读取
+    for (auto& pair : records) {
+        pair.second.style_known = false;
+    }
+}
+
+// 提交
+void WindowStylePlan::clear() {
+    updates.clear();
+    window_ids.clear();
+    owner_ids.clear();
+    status.clear();
+    ok.clear();
+}
+
+void WindowStyleManager::prepare(WindowRecord* const* p_records, const WindowStyleRequest* p_requests, size_t count, WindowStylePlan& r_plan) {
+    r_plan.clear();
+    r_plan.status.resize(count, -1);
+
+    for (size_t i = 0; i < count; i++) {
+        WindowRecord* record = p_records[i];
+        if (!record || !load_style(*record)) {
+            continue;
+        }
+
+        // 已经是目标状态，无需访问系统
+        WindowStyleRequest request = p_requests[i];
+        if (record->opacity_known && record->opacity < 255) {
+            request.keep_layered = true;
+        }
+        uint32_t target = compute_target_style(record->style, request);
+        if (target == record->style) {
+            r_plan.status[i] = 0;
+            stats_record_redundant();
+            continue;
+        }
+
+        WindowStyleUpdate update;
+        update.handle = record->handle;
+        update.old_style = record->style;
+        update.new_style = target;
+        record->in_flight++;
+        r_plan.updates.push_back(update);
+        r_plan.window_ids.push_back(record->window_id);
+        r_plan.owner_ids.push_back(record->owner_id);
+        r_plan.status[i] = (int)r_plan.updates.size();
+    }
+}
+
+int WindowStyleManager::finish(WindowStylePlan& plan) {
+    for (size_t i = 0; i < plan.updates.size(); i++) {
+        WindowRecord* record = find(plan.window_ids[i], plan.owner_ids[i]);
+        if (!record || record->handle != plan.updates[i].handle) {
+            continue; // 提交期间窗口已失效
+        }
+        record->in_flight--;
+        if (plan.updates[i].ok) {
+            record->style = plan.updates[i].new_style;
+        } else {
+            // 写入失败时不再信任影子状态
+            record->style_known = false;
+        }
+    }
+
+    int applied = 0;
+    plan.ok.resize(plan.status.size());
+    for (size_t i = 0; i < plan.status.size(); i++) {
+        int status = plan.status[i];
+        plan.ok[i] = status == 0 || (status > 0 && plan.updates[status - 1].ok);
+        applied += plan.ok[i];
+    }
+    return applied;
+}
+
+void WindowStyleManager::submit(WindowBackend* backend, WindowStylePlan& plan) {
+    if (plan.updates.empty()) {
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    backend->apply_styles(plan.updates.data(), plan.updates.size());
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    stats_record_native_change((uint64_t)elapsed.count(), plan.updates.size());
+}
+
+int WindowStyleManager::apply(WindowRecord* const* p_records, const WindowStyleRequest* p_requests, size_t count) {
+    prepare(p_records, p_requests, count, scratch_plan);
+    submit(backend.get(), scratch_plan);
+    return finish(scratch_plan);
+}
+
+int WindowStyleManager::apply(const WindowStyleBatch& batch) {
+    return apply(batch.get_records(), batch.get_requests(), batch.size());
+}
+
+// 不透明度
+void WindowOpacityPlan::clear() {
+    updates.clear();
+    window_ids.clear();
+    owner_ids.clear();
+    status.clear();
+    ok.clear();
+    layered.clear();
+    layered_records.clear();
+    layered_requests.clear();
+}
+
+bool WindowStyleManager::load_opacity(WindowRecord& record) {
+    if (record.opacity_known) {
+        return true;
+    }
+
+    uint8_t opacity = 255;
+    if (!backend->read_opacity(record.handle, opacity)) {
+        return false;
+    }
+
+    record.opacity = opacity;
+    record.opacity_known = true;
+    return true;
+}
+
+void WindowStyleManager::prepare_opacity(WindowRecord* const* p_records, const uint8_t* p_opacity, size_t count, WindowOpacityPlan& r_plan) {
+    r_plan.clear();
+    r_plan.status.resize(count, -1);
+    const bool needs_layered = backend->opacity_needs_layered();
+
+    for (size_t i = 0; i < count; i++) {
+        WindowRecord* record = p_records[i];
+        if (!record || !load_opacity(*record)) {
+            continue;
+        }
+        if (record->opacity == p_opacity[i]) {
+            r_plan.status[i] = 0;
+            stats_record_redundant();
+            continue;
+        }
+
+        // 半透明需要分层样式：缺少时与不透明度一起提交，255不需要（已有的LAYERED保留）
+        if (needs_layered && p_opacity[i] < 255) {
+            if (!load_style(*record)) {
+                continue;
+            }
+            if (!(record->style & WINDOW_STYLE_LAYERED)) {
+                WindowStyleRequest request;
+                request.keep_layered = true;
+                request.restore = true;
+                request.restore_style = WINDOW_STYLE_LAYERED;
+                request.restore_mask = WINDOW_STYLE_LAYERED;
+                r_plan.layered_records.push_back(record);
+                r_plan.layered_requests.push_back(request);
+            }
+        }
+
+        WindowOpacityUpdate update;
+        update.handle = record->handle;
+        update.opacity = p_opacity[i];
+        record->in_flight++;
+        r_plan.updates.push_back(update);
+        r_plan.window_ids.push_back(record->window_id);
+        r_plan.owner_ids.push_back(record->owner_id);
+        r_plan.status[i] = (int)r_plan.updates.size();
+    }
+    prepare(r_plan.layered_records.data(), r_plan.layered_requests.data(), r_plan.layered_records.size(), r_plan.layered);
+}
+
+void WindowStyleManager::submit_opacity(WindowBackend* backend, WindowOpacityPlan& plan) {
+    if (plan.updates.empty()) {
+        return;
+    }
+    // 先加上分层样式，再写入不透明度
+    submit(backend, plan.layered);
+    auto start = std::chrono::steady_clock::now();
+    backend->apply_opacity(plan.updates.data(), plan.updates.size());
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    stats_record_native_change((uint64_t)elapsed.count(), plan.updates.size());
+}
+
+int WindowStyleManager::finish_opacity(WindowOpacityPlan& plan) {
+    // 分层样式的写入结果按普通样式变更写回影子状态
+    finish(plan.layered);
+
+    for (size_t i = 0; i < plan.updates.size(); i++) {
+        WindowRecord* record = find(plan.window_ids[i], plan.owner_ids[i]);
+        if (!record || record->handle != plan.updates[i].handle) {
+            continue;
+        }
+        record->in_flight--;
+        if (!plan.updates[i].ok) {
+            record->opacity_known = false;
+            continue;
+        }
+        record->opacity = plan.updates[i].opacity;
+    }
+
+    int applied = 0;
+    plan.ok.resize(plan.status.size());
+    for (size_t i = 0; i < plan.status.size(); i++) {
+        int status = plan.status[i];
+        plan.ok[i] = status == 0 || (status > 0 && plan.updates[status - 1].ok);
+        applied += plan.ok[i];
+    }
+    return applied;
+}
+
+int WindowStyleManager::set_opacity(WindowRecord* const* p_records, const uint8_t* p_opacity, size_t count) {
+    prepare_opacity(p_records, p_opacity, count, scratch_opacity_plan);
+    submit_opacity(backend.get(), scratch_opacity_plan);
+    return finish_opacity(scratch_opacity_plan);
+}
+
+void WindowStyleManager::queue(const WindowRecord& record, const WindowStyleRequest& request) {
+    auto it = pending_index.find(record.window_id);
+    if (it != pending_index.end() && pending[it->second].owner_id == record.owner_id) {
+        pending[it->second].request.merge(request);
+        return;
+    }
+
+    PendingChange change;
+    change.window_id = record.window_id;
+    change.owner_id = record.owner_id;
+    change.request = request;
+    if (it != pending_index.end()) {
+        // 同一窗口ID已属于新对象，旧请求作废
+        pending[it->second] = change;
+        return;
+    }
+    pending_index[record.window_id] = pending.size();
+    pending.push_back(change);
+}
+
+int WindowStyleManager::commit() {
+    if (pending.empty()) {
+        return 0;
+    }
+
+    // 提交前窗口可能已经失效，只提交仍在缓存中的窗口
+    commit_batch.clear();
+    for (const PendingChange& change : pending) {
+        commit_batch.add(find(change.window_id, change.owner_id), change.request);
+    }
+    pending.clear();
+    pending_index.clear();
+    return apply(commit_batch);
+}
+
+bool WindowStyleManager::is_taskbar_visible(uint32_t style) {
+    return (style & WINDOW_STYLE_APP_WINDOW) && !(style & WINDOW_STYLE_TOOL_WINDOW);
+}
+
+bool WindowStyleManager::is_clickable(uint32_t style) {
+    return (style & WINDOW_STYLE_CLICK_THROUGH_MASK) != WINDOW_STYLE_CLICK_THROUGH_MASK;
+}
+
+uint32_t WindowStyleManager::compute_target_style(uint32_t style, const WindowStyleRequest& request) {
+    if (request.set_taskbar) {
+        if (request.taskbar_visible) {
+            style = (style | WINDOW_STYLE_APP_WINDOW) & ~WINDOW_STYLE_TOOL_WINDOW;
+        } else {
+            style = (style & ~WINDOW_STYLE_APP_WINDOW) | WINDOW_STYLE_TOOL_WINDOW;
+        }
+    }
+    if (request.set_clickable) {
+        if (request.clickable) {
+            style &= request.keep_layered ? ~WINDOW_STYLE_TRANSPARENT : ~WINDOW_STYLE_CLICK_THROUGH_MASK;
+        } else {
+            style |= WINDOW_STYLE_CLICK_THROUGH_MASK;
+        }
+    }
+    if (request.restore) {
+        style = (style & ~request.restore_mask) | (request.restore_style & request.restore_mask);
+    }
+    return style;
+}
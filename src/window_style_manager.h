@@ -0,0 +1,173 @@
+#ifndef WINDOW_STYLE_MANAGER_H
+#define WINDOW_STYLE_MANAGER_H
+
+#include "window_backend.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// 按窗口ID查询原生句柄的回调（Godot中通过DisplayServer实现，测试时由伪后端提供）
+typedef NativeWindowHandle (*WindowHandleLookup)(uint32_t window_id, void* userdata);
+
+// 一个窗口的目标状态，未设置的部分保持不变
+struct WindowStyleRequest {
+    bool set_taskbar = false;
+    bool taskbar_visible = false;
+    bool set_clickable = false;
+    bool clickable = true;
+    // 设为可点击时保留LAYERED，只去掉TRANSPARENT（悬停穿透频繁切换时使用）
+    bool keep_layered = false;
+    // 把restore_mask内的样式位直接恢复为restore_style（外部修改后重新写入时使用），在上面的字段之后生效
+    bool restore = false;
+    uint32_t restore_style = 0;
+    uint32_t restore_mask = 0;
+
+    // 后到的请求覆盖先前的目标状态
+    void merge(const WindowStyleRequest& other);
+};
+
+// 缓存的窗口记录：原生句柄 + 所属对象ID + 受管理样式位的影子状态
+struct WindowRecord {
+    uint32_t window_id = 0;
+    uint64_t owner_id = 0;
+    NativeWindowHandle handle = 0;
+    uint32_t style = 0;
+    bool style_known = false;
+    bool watched = false;  // 前端是否已监听对应Window的失效信号
+    uint8_t opacity = 255;  // 不透明度的影子状态，第一次使用时读取
+    bool opacity_known = false;
+    uint32_t in_flight = 0; // prepare与finish之间尚未写回影子状态的变更数
+};
+
+// 同一批次的变更，同一窗口的多次请求合并为一条
+class WindowStyleBatch {
+public:
+    static const size_t INVALID_INDEX = (size_t)-1;
+
+    // 返回合并后的序号，record为空时返回INVALID_INDEX
+    size_t add(WindowRecord* record, const WindowStyleRequest& request);
+    void clear();
+
+    size_t size() const { return records.size(); }
+    WindowRecord* const* get_records() const { return records.data(); }
+    const WindowStyleRequest* get_requests() const { return requests.data(); }
+
+private:
+    std::vector<WindowRecord*> records;
+    std::vector<WindowStyleRequest> requests;
+    std::unordered_map<WindowRecord*, size_t> index;
+};
+
+// 两段式提交的中间结果：prepare计算需要写入的变更，调用方执行backend->apply_styles后再finish
+// 窗口以ID+所属对象ID记录，两段之间缓存被修改也不会访问失效的记录。
+struct WindowStylePlan {
+    std::vector<WindowStyleUpdate> updates;
+    std::vector<uint32_t> window_ids;   // 与updates一一对应
+    std::vector<uint64_t> owner_ids;
+    std::vector<int> status;            // 每条输入：-1失败，0已是目标状态，k > 0为updates[k - 1]
+    std::vector<char> ok;               // finish后每条输入是否处于目标状态
+
+    void clear();
+};
+
+// 不透明度的两段式提交，与WindowStylePlan相同
+// 后端需要分层样式时，还没有LAYERED的半透明窗口在layered中带一条加上LAYERED的样式变更，先于不透明度写入。
+struct WindowOpacityPlan {
+    std::vector<WindowOpacityUpdate> updates;
+    std::vector<uint32_t> window_ids;   // 与updates一一对应
+    std::vector<uint64_t> owner_ids;
+    std::vector<int> status;            // 每条输入：-1失败，0已是目标值，k > 0为updates[k - 1]
+    std::vector<char> ok;
+    WindowStylePlan layered;
+    std::vector<WindowRecord*> layered_records; // 只在prepare_opacity中使用
+    std::vector<WindowStyleRequest> layered_requests;
+
+    void clear();
+};
+
+// 平台无关的核心逻辑：句柄缓存、样式影子状态、变更合并与提交
+// 不依赖Godot，可以配合伪后端单独编译。
+class WindowStyleManager {
+public:
+    // 与DisplayServer::MAIN_WINDOW_ID一致
+    static const uint32_t MAIN_WINDOW_ID = 0;
+
+    WindowStyleManager();
+
+    void set_backend(std::unique_ptr<WindowBackend> p_backend);
+    WindowBackend* get_backend() const { return backend.get(); }
+    void set_handle_lookup(WindowHandleLookup p_lookup, void* p_userdata);
+
+    // 句柄缓存，owner_id用于识别同一窗口ID是否属于原来的对象
+    // 主窗口查不到或句柄无效时使用后端的备用查找，结果同样缓存
+    WindowRecord* resolve(uint32_t window_id, uint64_t owner_id, bool* r_inserted = nullptr);
+    WindowRecord* find(uint32_t window_id, uint64_t owner_id);
+    // 按原生句柄查找（线性查找，只用于外部样式变化通知）
+    WindowRecord* find_by_handle(NativeWindowHandle handle);
+    // 不经过缓存直接查询句柄（窗口正在创建、缓存可能过期时使用）
+    NativeWindowHandle lookup_handle(uint32_t window_id) const;
+    void invalidate(uint32_t window_id, uint64_t owner_id);
+    void clear();
+
+    uint64_t get_cache_hits() const { return cache_hits; }
+    uint64_t get_cache_misses() const { return cache_misses; }
+    size_t get_cache_size() const { return records.size(); }
+
+    // 影子状态：首次访问时读取系统，之后直接使用内存中的值
+    bool load_style(WindowRecord& record);
+    bool resync(WindowRecord& record);
+    void resync_all();
+
+    // 立即提交，返回处于目标状态的窗口数量（本来就处于目标状态的也计入）
+    int apply(WindowRecord* const* p_records, const WindowStyleRequest* p_requests, size_t count);
+    int apply(const WindowStyleBatch& batch);
+
+    // 两段式提交（异步执行器在锁外调用后端时使用），finish返回处于目标状态的窗口数量
+    void prepare(WindowRecord* const* p_records, const WindowStyleRequest* p_requests, size_t count, WindowStylePlan& r_plan);
+    // 调用后端写入计划中的变更并记录耗时（不访问缓存，可以在锁外调用）
+    static void submit(WindowBackend* backend, WindowStylePlan& plan);
+    int finish(WindowStylePlan& plan);
+
+    // 不透明度：影子状态一致时不访问系统。需要分层样式的后端（Win32）由这里经apply_styles加上LAYERED，
+    // 样式影子状态随之更新；不透明度低于255的窗口设为可点击时保留LAYERED，避免去掉分层样式后透明度丢失
+    bool load_opacity(WindowRecord& record);
+    int set_opacity(WindowRecord* const* p_records, const uint8_t* p_opacity, size_t count);
+    void prepare_opacity(WindowRecord* const* p_records, const uint8_t* p_opacity, size_t count, WindowOpacityPlan& r_plan);
+    static void submit_opacity(WindowBackend* backend, WindowOpacityPlan& plan);
+    int finish_opacity(WindowOpacityPlan& plan);
+
+    // 队列：按窗口合并，commit时一次提交
+    void queue(const WindowRecord& record, const WindowStyleRequest& request);
+    bool has_pending() const { return !pending.empty(); }
+    int commit();
+
+    static bool is_taskbar_visible(uint32_t style);
+    static bool is_clickable(uint32_t style);
+    static uint32_t compute_target_style(uint32_t style, const WindowStyleRequest& request);
+
+private:
+    struct PendingChange {
+        uint32_t window_id = 0;
+        uint64_t owner_id = 0;
+        WindowStyleRequest request;
+    };
+
+    std::unique_ptr<WindowBackend> backend;
+    WindowHandleLookup lookup = nullptr;
+    void* lookup_userdata = nullptr;
+
+    std::unordered_map<uint32_t, WindowRecord> records;
+    uint64_t cache_hits = 0;
+    uint64_t cache_misses = 0;
+
+    std::vector<PendingChange> pending;
+    std::unordered_map<uint32_t, size_t> pending_index;
+
+    // 复用的临时缓冲区，避免每次提交都分配内存
+    WindowStylePlan scratch_plan;
+    WindowOpacityPlan scratch_opacity_plan;
+    WindowStyleBatch commit_batch;
+};
+
+#endif // WINDOW_STYLE_MANAGER_H
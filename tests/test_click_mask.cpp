@@ -0,0 +1,133 @@
+// ClickMask测试：RGBA8/ALPHA8两条路径得到相同的区域，透明度提取与阈值化一致，
+// 按脏矩形增量更新与重新构建的结果相同
+
+#include "test_common.h"
+
+#include "click_mask.h"
+
+#include <vector>
+
+// 宽度不是16/64的倍数，覆盖SIMD之后的逐像素部分
+static const int32_t WIDTH = 203;
+static const int32_t HEIGHT = 37;
+
+static std::vector<uint8_t> make_rgba(uint32_t seed) {
+    std::vector<uint8_t> pixels((size_t)WIDTH * HEIGHT * 4);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        seed = seed * 1103515245u + 12345u;
+        pixels[i] = (uint8_t)(seed >> 24);
+    }
+    return pixels;
+}
+
+static bool same_rects(const std::vector<MaskRect>& a, const std::vector<MaskRect>& b) {
+    bool same = a.size() == b.size();
+    for (size_t i = 0; same && i < a.size(); i++) {
+        same = a[i].x == b[i].x && a[i].y == b[i].y && a[i].width == b[i].width && a[i].height == b[i].height;
+    }
+    return same;
+}
+
+// 反转透明度一定跨过阈值128，使这些像素的位全部变化
+static void invert_span(std::vector<uint8_t>& alpha, int32_t y, int32_t x0, int32_t x1) {
+    for (int32_t x = x0; x < x1; x++) {
+        alpha[(size_t)y * WIDTH + x] = (uint8_t)(255 - alpha[(size_t)y * WIDTH + x]);
+    }
+}
+
+static std::vector<uint8_t> make_alpha(uint32_t seed) {
+    std::vector<uint8_t> rgba = make_rgba(seed);
+    std::vector<uint8_t> alpha((size_t)WIDTH * HEIGHT);
+    ClickMask::extract_alpha(rgba.data(), WIDTH, HEIGHT, (size_t)WIDTH * 4, CLICK_MASK_RGBA8, alpha.data());
+    return alpha;
+}
+
+TEST_CASE(extract_alpha_matches_alpha_channel) {
+    std::vector<uint8_t> rgba = make_rgba(1);
+    std::vector<uint8_t> alpha((size_t)WIDTH * HEIGHT);
+    ClickMask::extract_alpha(rgba.data(), WIDTH, HEIGHT, (size_t)WIDTH * 4, CLICK_MASK_RGBA8, alpha.data());
+
+    bool same = true;
+    for (size_t i = 0; i < alpha.size(); i++) {
+        same = same && alpha[i] == rgba[i * 4 + 3];
+    }
+    CHECK(same);
+}
+
+TEST_CASE(alpha8_mask_matches_rgba8_mask) {
+    std::vector<uint8_t> rgba = make_rgba(2);
+    std::vector<uint8_t> alpha((size_t)WIDTH * HEIGHT);
+    ClickMask::extract_alpha(rgba.data(), WIDTH, HEIGHT, (size_t)WIDTH * 4, CLICK_MASK_RGBA8, alpha.data());
+
+    ClickMask from_rgba;
+    ClickMask from_alpha;
+    from_rgba.build(rgba.data(), WIDTH, HEIGHT, (size_t)WIDTH * 4, CLICK_MASK_RGBA8, 128);
+    from_alpha.build(alpha.data(), WIDTH, HEIGHT, (size_t)WIDTH, CLICK_MASK_ALPHA8, 128);
+
+    CHECK(!from_rgba.get_rects().empty());
+    CHECK(same_rects(from_rgba.get_rects(), from_alpha.get_rects()));
+}
+
+TEST_CASE(update_reports_unchanged_mask) {
+    std::vector<uint8_t> alpha((size_t)WIDTH * HEIGHT, 0);
+    for (int32_t y = 10; y < 20; y++) {
+        for (int32_t x = 30; x < 90; x++) {
+            alpha[(size_t)y * WIDTH + x] = 255;
+        }
+    }
+
+    ClickMask mask;
+    CHECK(mask.update(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128));
+    CHECK(mask.get_rects().size() == 1);
+    CHECK(!mask.update(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128));
+
+    alpha[(size_t)25 * WIDTH + 5] = 255;
+    CHECK(mask.update(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128));
+    CHECK(mask.get_changed_rows() == 1);
+    CHECK(mask.get_rects().size() == 2);
+}
+
+TEST_CASE(dirty_update_matches_full_build) {
+    std::vector<uint8_t> alpha = make_alpha(3);
+    ClickMask mask;
+    CHECK(mask.update(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128));
+
+    // 脏矩形x=[50, 80)不按64对齐并跨过第一个64位字的边界，只改其中三行
+    invert_span(alpha, 6, 50, 80);
+    invert_span(alpha, 9, 60, 70);
+    invert_span(alpha, 14, 79, 80);
+    MaskRect dirty = { 50, 5, 30, 10 };
+    CHECK(mask.update(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128, &dirty));
+    CHECK(mask.get_changed_rows() == 3);
+
+    ClickMask fresh;
+    fresh.build(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128);
+    CHECK(same_rects(mask.get_rects(), fresh.get_rects()));
+
+    // 脏矩形内没有变化
+    CHECK(!mask.update(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128, &dirty));
+    CHECK(mask.get_changed_rows() == 0);
+}
+
+TEST_CASE(dirty_update_clips_rect_to_image) {
+    std::vector<uint8_t> alpha = make_alpha(4);
+    ClickMask mask;
+    CHECK(mask.update(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128));
+
+    // 超出左上角的脏矩形裁剪为x=[0, 13)、y=[0, 2)
+    invert_span(alpha, 1, 0, 13);
+    MaskRect corner = { -7, -3, 20, 5 };
+    CHECK(mask.update(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128, &corner));
+    CHECK(mask.get_changed_rows() == 1);
+
+    // 超出右下角的脏矩形
+    invert_span(alpha, HEIGHT - 1, WIDTH - 20, WIDTH);
+    invert_span(alpha, HEIGHT - 3, WIDTH - 1, WIDTH);
+    MaskRect tail = { WIDTH - 20, HEIGHT - 4, 100, 100 };
+    CHECK(mask.update(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128, &tail));
+    CHECK(mask.get_changed_rows() == 2);
+
+    ClickMask fresh;
+    fresh.build(alpha.data(), WIDTH, HEIGHT, WIDTH, CLICK_MASK_ALPHA8, 128);
+    CHECK(same_rects(mask.get_rects(), fresh.get_rects()));
+}
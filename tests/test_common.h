@@ -0,0 +1,46 @@
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+// 单元测试公共部分：测试注册、断言与汇总（不依赖godot-cpp）
+// TEST_CASE定义的测试在静态初始化时注册，由test_main.cpp依次运行；CHECK失败时记录位置并继续执行。
+
+#include <cstdio>
+#include <vector>
+
+struct TestCase {
+    const char* name;
+    void (*func)();
+};
+
+inline std::vector<TestCase>& test_registry() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+struct TestRegistrar {
+    TestRegistrar(const char* name, void (*func)()) {
+        test_registry().push_back(TestCase{ name, func });
+    }
+};
+
+inline bool test_check(bool ok, const char* expression, const char* file, int line) {
+    if (!ok) {
+        test_failures()++;
+        printf("  FAILED %s:%d: %s\n", file, line, expression);
+    }
+    return ok;
+}
+
+#define TEST_CASE(name)                                        \
+    static void name();                                        \
+    static TestRegistrar name##_registrar(#name, &name);       \
+    static void name()
+
+#define CHECK(expression) test_check((expression), #expression, __FILE__, __LINE__)
+
+#endif // TEST_COMMON_H
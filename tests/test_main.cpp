@@ -0,0 +1,21 @@
+// 单元测试入口：scons test 构建并运行，任何检查失败时返回非0
+// 也可以直接运行 bin/run_tests [测试名]，只运行名字匹配的测试
+
+#include "test_common.h"
+
+#include <cstring>
+
+int main(int argc, char** argv) {
+    int run = 0;
+    for (const TestCase& test : test_registry()) {
+        if (argc > 1 && strcmp(argv[1], test.name) != 0) {
+            continue;
+        }
+        int before = test_failures();
+        test.func();
+        printf("%s %s\n", test_failures() == before ? "ok    " : "FAILED", test.name);
+        run++;
+    }
+    printf("%d tests, %d failed checks\n", run, test_failures());
+    return test_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+// StyleProfile：保存/载入往返，格式错误、版本过新与截断的数据被拒绝且不修改原有配置
+
+#include "test_common.h"
+
+#include "style_profile.h"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static std::vector<uint8_t> write_profile(const std::map<std::string, uint8_t>& entries) {
+    std::vector<uint8_t> data(StyleProfile::get_size(entries));
+    StyleProfile::write(entries, data.data());
+    return data;
+}
+
+static std::map<std::string, uint8_t> sample_entries() {
+    WindowStyleRequest hidden;
+    hidden.restore_style = WINDOW_STYLE_TOOL_WINDOW;
+    hidden.restore_mask = StyleProfile::STYLE_MASK;
+    WindowStyleRequest click_through;
+    click_through.restore_style = WINDOW_STYLE_APP_WINDOW | WINDOW_STYLE_CLICK_THROUGH_MASK;
+    click_through.restore_mask = StyleProfile::STYLE_MASK;
+
+    std::map<std::string, uint8_t> entries;
+    entries["/root/Main/Overlay"] = StyleProfile::pack(hidden);
+    entries["/root/Main/Pet"] = StyleProfile::pack(click_through);
+    return entries;
+}
+
+// 解析失败时原有配置保持不变
+static StyleProfile::Result parse_keeps_previous(const std::vector<uint8_t>& data) {
+    std::unordered_map<std::string, WindowStyleRequest> entries;
+    entries["/root/Previous"] = WindowStyleRequest();
+    StyleProfile::Result result = StyleProfile::parse(data.data(), data.size(), entries);
+    if (result != StyleProfile::OK) {
+        CHECK(entries.size() == 1 && entries.count("/root/Previous") == 1);
+    }
+    return result;
+}
+
+TEST_CASE(profile_round_trip) {
+    std::vector<uint8_t> data = write_profile(sample_entries());
+    CHECK(data.size() == StyleProfile::HEADER_SIZE + (3 + 18) + (3 + 14));
+
+    std::unordered_map<std::string, WindowStyleRequest> entries;
+    CHECK(StyleProfile::parse(data.data(), data.size(), entries) == StyleProfile::OK);
+    CHECK(entries.size() == 2);
+    const WindowStyleRequest& pet = entries["/root/Main/Pet"];
+    CHECK(pet.restore && pet.restore_mask == StyleProfile::STYLE_MASK);
+    CHECK(pet.restore_style == (WINDOW_STYLE_APP_WINDOW | WINDOW_STYLE_CLICK_THROUGH_MASK));
+    CHECK(entries["/root/Main/Overlay"].restore_style == WINDOW_STYLE_TOOL_WINDOW);
+
+    // 相同状态保存的结果相同
+    CHECK(write_profile(sample_entries()) == data);
+}
+
+TEST_CASE(profile_empty_is_valid) {
+    std::vector<uint8_t> data = write_profile(std::map<std::string, uint8_t>());
+    CHECK(data.size() == StyleProfile::HEADER_SIZE);
+    std::unordered_map<std::string, WindowStyleRequest> entries;
+    entries["/root/Previous"] = WindowStyleRequest();
+    CHECK(StyleProfile::parse(data.data(), data.size(), entries) == StyleProfile::OK);
+    CHECK(entries.empty());
+}
+
+TEST_CASE(profile_rejects_malformed_header) {
+    std::vector<uint8_t> data = write_profile(sample_entries());
+
+    CHECK(parse_keeps_previous(std::vector<uint8_t>()) == StyleProfile::INVALID);
+    CHECK(parse_keeps_previous(std::vector<uint8_t>(data.begin(), data.begin() + StyleProfile::HEADER_SIZE - 1)) == StyleProfile::INVALID);
+
+    std::vector<uint8_t> bad_magic = data;
+    bad_magic[3] = 'X';
+    CHECK(parse_keeps_previous(bad_magic) == StyleProfile::INVALID);
+
+    std::vector<uint8_t> newer = data;
+    newer[4] = StyleProfile::VERSION + 1;
+    CHECK(parse_keeps_previous(newer) == StyleProfile::UNSUPPORTED_VERSION);
+
+    // 条目之后的多余数据
+    std::vector<uint8_t> trailing = data;
+    trailing.push_back(0);
+    CHECK(parse_keeps_previous(trailing) == StyleProfile::INVALID);
+}
+
+TEST_CASE(profile_rejects_truncated_entries) {
+    std::vector<uint8_t> data = write_profile(sample_entries());
+
+    // 每一种在条目中间截断的长度都被拒绝
+    bool all_rejected = true;
+    for (size_t size = StyleProfile::HEADER_SIZE; size < data.size(); size++) {
+        all_rejected = all_rejected
+            && parse_keeps_previous(std::vector<uint8_t>(data.begin(), data.begin() + size)) == StyleProfile::TRUNCATED;
+    }
+    CHECK(all_rejected);
+
+    // 条目数大于实际条目
+    std::vector<uint8_t> overcount = data;
+    overcount[8] = 3;
+    CHECK(parse_keeps_previous(overcount) == StyleProfile::TRUNCATED);
+
+    // 路径长度超出数据末尾
+    std::vector<uint8_t> long_path = data;
+    long_path[StyleProfile::HEADER_SIZE] = 0xFF;
+    long_path[StyleProfile::HEADER_SIZE + 1] = 0xFF;
+    CHECK(parse_keeps_previous(long_path) == StyleProfile::TRUNCATED);
+}
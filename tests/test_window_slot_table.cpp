@@ -0,0 +1,72 @@
+// WindowSlotTable：ID编码、释放后旧ID失效、槽位复用时代数递增
+
+#include "test_common.h"
+
+#include "window_slot_table.h"
+
+TEST_CASE(slot_ids_resolve_to_owner) {
+    WindowSlotTable table;
+    int64_t a = table.add(100);
+    int64_t b = table.add(200);
+    CHECK(a != WindowSlotTable::INVALID_ID && b != WindowSlotTable::INVALID_ID && a != b);
+    CHECK(a > 0 && b > 0);
+    CHECK(table.size() == 2);
+
+    WindowSlot* slot = table.get(a);
+    CHECK(slot && slot->owner_id == 100 && slot->window_id == WindowSlot::NO_WINDOW);
+    CHECK(table.get(b) && table.get(b)->owner_id == 200);
+}
+
+TEST_CASE(slot_rejects_invalid_ids) {
+    WindowSlotTable table;
+    int64_t id = table.add(100);
+    CHECK(table.get(WindowSlotTable::INVALID_ID) == nullptr);
+    CHECK(table.get(-id) == nullptr);
+    // 序号越界
+    CHECK(table.get(id + 1) == nullptr);
+    // 序号正确但代数不符
+    CHECK(table.get(id + ((int64_t)1 << 32)) == nullptr);
+    // 只有序号、代数为0
+    CHECK(table.get(id & 0xFFFFFFFF) == nullptr);
+}
+
+TEST_CASE(slot_stale_id_rejected_after_reuse) {
+    WindowSlotTable table;
+    int64_t old_id = table.add(100);
+    CHECK(table.remove(old_id));
+    CHECK(table.get(old_id) == nullptr);
+    CHECK(!table.remove(old_id));
+    CHECK(table.size() == 0);
+
+    // 同一槽位复用：序号相同、代数不同，旧ID不会指向新窗口
+    int64_t new_id = table.add(300);
+    CHECK((new_id & 0xFFFFFFFF) == (old_id & 0xFFFFFFFF));
+    CHECK(new_id != old_id);
+    CHECK(table.get(old_id) == nullptr);
+    CHECK(table.get(new_id) && table.get(new_id)->owner_id == 300);
+}
+
+TEST_CASE(slot_reuse_resets_window_id) {
+    WindowSlotTable table;
+    int64_t id = table.add(100);
+    table.get(id)->window_id = 7;
+    table.remove(id);
+
+    int64_t reused = table.add(200);
+    CHECK(table.get(reused) && table.get(reused)->window_id == WindowSlot::NO_WINDOW);
+}
+
+TEST_CASE(slot_clear_invalidates_issued_ids) {
+    WindowSlotTable table;
+    int64_t a = table.add(100);
+    int64_t b = table.add(200);
+    table.clear();
+    CHECK(table.size() == 0);
+    CHECK(table.get(a) == nullptr && table.get(b) == nullptr);
+
+    // 清空后重新登记的ID与清空前的都不相同
+    int64_t c = table.add(300);
+    int64_t d = table.add(400);
+    CHECK(c != a && c != b && d != a && d != b);
+    CHECK(table.get(c) && table.get(d));
+}
@@ -0,0 +1,286 @@
+// WindowStyleManager：句柄缓存、影子状态、请求合并、队列与两段式提交（伪后端）
+
+#include "test_common.h"
+#include "window_backend_fake.h"
+#include "window_style_manager.h"
+
+// 每个测试使用新的管理器与伪后端，所属对象ID与窗口ID相同
+struct TestWindows {
+    WindowStyleManager manager;
+    FakeWindowBackend* backend = nullptr;
+
+    TestWindows() {
+        backend = new FakeWindowBackend();
+        manager.set_backend(std::unique_ptr<WindowBackend>(backend));
+        manager.set_handle_lookup(FakeWindowBackend::lookup_handle, backend);
+    }
+
+    NativeWindowHandle create(uint32_t window_id, uint32_t style = WINDOW_STYLE_APP_WINDOW) {
+        return backend->create_window(window_id, style);
+    }
+
+    WindowRecord* resolve(uint32_t window_id) {
+        return manager.resolve(window_id, window_id);
+    }
+
+    uint32_t style_of(NativeWindowHandle handle) const {
+        return backend->get_window(handle)->style;
+    }
+};
+
+static WindowStyleRequest taskbar_request(bool visible) {
+    WindowStyleRequest request;
+    request.set_taskbar = true;
+    request.taskbar_visible = visible;
+    return request;
+}
+
+static WindowStyleRequest clickable_request(bool clickable) {
+    WindowStyleRequest request;
+    request.set_clickable = true;
+    request.clickable = clickable;
+    return request;
+}
+
+TEST_CASE(resolve_caches_handle) {
+    TestWindows windows;
+    NativeWindowHandle handle = windows.create(1);
+
+    WindowRecord* first = windows.resolve(1);
+    WindowRecord* second = windows.resolve(1);
+    CHECK(first && first == second);
+    CHECK(first && first->handle == handle);
+    CHECK(windows.backend->get_counters().lookups == 1);
+    CHECK(windows.manager.get_cache_hits() == 1 && windows.manager.get_cache_misses() == 1);
+
+    // 同一窗口ID换了所属对象：旧记录作废并重新查找
+    WindowRecord* other = windows.manager.resolve(1, 99);
+    CHECK(other && other->owner_id == 99);
+    CHECK(windows.backend->get_counters().lookups == 2);
+    CHECK(windows.manager.find(1, 1) == nullptr);
+}
+
+TEST_CASE(redundant_write_skipped_by_shadow) {
+    TestWindows windows;
+    NativeWindowHandle handle = windows.create(1);
+    WindowRecord* record = windows.resolve(1);
+    WindowStyleRequest hide = taskbar_request(false);
+
+    CHECK(windows.manager.apply(&record, &hide, 1) == 1);
+    CHECK(!WindowStyleManager::is_taskbar_visible(windows.style_of(handle)));
+    FakeWindowBackend::Counters after_first = windows.backend->get_counters();
+    CHECK(after_first.style_writes == 1 && after_first.style_reads == 1);
+
+    // 影子状态已是目标状态：不读取、不写入，也不调用后端
+    CHECK(windows.manager.apply(&record, &hide, 1) == 1);
+    FakeWindowBackend::Counters after_second = windows.backend->get_counters();
+    CHECK(after_second.style_writes == 1);
+    CHECK(after_second.style_reads == 1);
+    CHECK(after_second.batches == after_first.batches);
+}
+
+TEST_CASE(batch_merges_requests_per_window) {
+    TestWindows windows;
+    NativeWindowHandle a = windows.create(1);
+    NativeWindowHandle b = windows.create(2);
+    WindowRecord* record_a = windows.resolve(1);
+    WindowRecord* record_b = windows.resolve(2);
+
+    WindowStyleBatch batch;
+    size_t first = batch.add(record_a, taskbar_request(false));
+    batch.add(record_b, taskbar_request(false));
+    size_t merged = batch.add(record_a, clickable_request(false));
+    // 同一窗口后到的请求覆盖先前的目标
+    batch.add(record_b, taskbar_request(true));
+    CHECK(first == merged);
+    CHECK(batch.size() == 2);
+    CHECK(batch.add(nullptr, taskbar_request(true)) == WindowStyleBatch::INVALID_INDEX);
+
+    CHECK(windows.manager.apply(batch) == 2);
+    CHECK(!WindowStyleManager::is_taskbar_visible(windows.style_of(a)));
+    CHECK(!WindowStyleManager::is_clickable(windows.style_of(a)));
+    CHECK(WindowStyleManager::is_taskbar_visible(windows.style_of(b)));
+    // 每个窗口只写一次，整批一次后端调用；b本来就显示在任务栏，不写入
+    FakeWindowBackend::Counters counters = windows.backend->get_counters();
+    CHECK(counters.batches == 1);
+    CHECK(counters.style_writes == 1);
+}
+
+TEST_CASE(queue_commit_keeps_last_request) {
+    TestWindows windows;
+    NativeWindowHandle a = windows.create(1);
+    NativeWindowHandle b = windows.create(2);
+    WindowRecord* record_a = windows.resolve(1);
+    WindowRecord* record_b = windows.resolve(2);
+
+    windows.manager.queue(*record_a, taskbar_request(false));
+    windows.manager.queue(*record_b, clickable_request(false));
+    windows.manager.queue(*record_a, taskbar_request(true));
+    windows.manager.queue(*record_a, clickable_request(false));
+    CHECK(windows.manager.has_pending());
+    // 提交前不访问系统
+    CHECK(windows.backend->get_counters().style_writes == 0);
+
+    CHECK(windows.manager.commit() == 2);
+    CHECK(!windows.manager.has_pending());
+    CHECK(WindowStyleManager::is_taskbar_visible(windows.style_of(a)));
+    CHECK(!WindowStyleManager::is_clickable(windows.style_of(a)));
+    CHECK(!WindowStyleManager::is_clickable(windows.style_of(b)));
+    CHECK(windows.backend->get_counters().batches == 1);
+    CHECK(windows.manager.commit() == 0);
+}
+
+TEST_CASE(queue_drops_invalidated_windows) {
+    TestWindows windows;
+    NativeWindowHandle a = windows.create(1);
+    NativeWindowHandle b = windows.create(2);
+    windows.manager.queue(*windows.resolve(1), taskbar_request(false));
+    windows.manager.queue(*windows.resolve(2), taskbar_request(false));
+
+    windows.manager.invalidate(1, 1);
+    CHECK(windows.manager.commit() == 1);
+    CHECK(WindowStyleManager::is_taskbar_visible(windows.style_of(a)));
+    CHECK(!WindowStyleManager::is_taskbar_visible(windows.style_of(b)));
+}
+
+TEST_CASE(invalidate_forces_re_resolve) {
+    TestWindows windows;
+    windows.create(1);
+    WindowRecord* record = windows.resolve(1);
+    WindowStyleRequest hide = taskbar_request(false);
+    CHECK(windows.manager.apply(&record, &hide, 1) == 1);
+
+    // 原生窗口重建：旧句柄销毁，同一窗口ID对应新句柄
+    windows.backend->destroy_window(record->handle);
+    NativeWindowHandle recreated = windows.create(1);
+    windows.manager.invalidate(1, 1);
+    CHECK(windows.manager.find(1, 1) == nullptr);
+
+    record = windows.resolve(1);
+    CHECK(record && record->handle == recreated);
+    CHECK(record && !record->style_known);
+    CHECK(windows.backend->get_counters().lookups == 2);
+
+    // 新窗口的影子状态重新读取，隐藏请求再次写入
+    CHECK(windows.manager.apply(&record, &hide, 1) == 1);
+    CHECK(!WindowStyleManager::is_taskbar_visible(windows.style_of(recreated)));
+    CHECK(windows.backend->get_counters().style_reads == 2);
+}
+
+TEST_CASE(failed_write_rolls_back_shadow) {
+    TestWindows windows;
+    NativeWindowHandle a = windows.create(1);
+    NativeWindowHandle b = windows.create(2);
+    WindowRecord* records[2] = { windows.resolve(1), windows.resolve(2) };
+    WindowStyleRequest requests[2] = { taskbar_request(false), taskbar_request(false) };
+
+    windows.backend->set_fail_writes(a, true);
+    WindowStylePlan plan;
+    windows.manager.prepare(records, requests, 2, plan);
+    CHECK(plan.updates.size() == 2);
+    CHECK(records[0]->in_flight == 1 && records[1]->in_flight == 1);
+    WindowStyleManager::submit(windows.backend, plan);
+    CHECK(windows.manager.finish(plan) == 1);
+    CHECK(plan.ok[0] == 0 && plan.ok[1] == 1);
+    CHECK(records[0]->in_flight == 0 && records[1]->in_flight == 0);
+
+    // 失败的窗口不再信任影子状态，下一次请求重新读取系统
+    CHECK(!records[0]->style_known);
+    CHECK(records[1]->style_known && !WindowStyleManager::is_taskbar_visible(records[1]->style));
+    CHECK(WindowStyleManager::is_taskbar_visible(windows.style_of(a)));
+    CHECK(!WindowStyleManager::is_taskbar_visible(windows.style_of(b)));
+
+    windows.backend->set_fail_writes(a, false);
+    uint64_t reads = windows.backend->get_counters().style_reads;
+    CHECK(windows.manager.apply(&records[0], &requests[0], 1) == 1);
+    CHECK(windows.backend->get_counters().style_reads == reads + 1);
+    CHECK(!WindowStyleManager::is_taskbar_visible(windows.style_of(a)));
+}
+
+TEST_CASE(finish_ignores_windows_invalidated_in_flight) {
+    TestWindows windows;
+    windows.create(1);
+    WindowRecord* record = windows.resolve(1);
+    WindowStyleRequest hide = taskbar_request(false);
+
+    WindowStylePlan plan;
+    windows.manager.prepare(&record, &hide, 1, plan);
+    WindowStyleManager::submit(windows.backend, plan);
+    // 两段之间记录被删除：finish不能访问旧记录
+    windows.manager.invalidate(1, 1);
+    CHECK(windows.manager.finish(plan) == 1);
+    CHECK(windows.manager.find(1, 1) == nullptr);
+}
+
+TEST_CASE(opacity_adds_layered_through_shadow) {
+    TestWindows windows;
+    NativeWindowHandle handle = windows.create(1);
+    WindowRecord* record = windows.resolve(1);
+    uint8_t half = 128;
+
+    // LAYERED与不透明度在同一次提交中写入，影子状态直接更新，不需要重新读取
+    CHECK(windows.manager.set_opacity(&record, &half, 1) == 1);
+    CHECK(windows.style_of(handle) & WINDOW_STYLE_LAYERED);
+    CHECK(windows.backend->get_window(handle)->opacity == 128);
+    CHECK(record->style_known && record->style == windows.style_of(handle));
+    CHECK(record->in_flight == 0);
+
+    // 已经是分层窗口：只写不透明度
+    FakeWindowBackend::Counters before = windows.backend->get_counters();
+    uint8_t quarter = 64;
+    CHECK(windows.manager.set_opacity(&record, &quarter, 1) == 1);
+    FakeWindowBackend::Counters after = windows.backend->get_counters();
+    CHECK(after.style_writes == before.style_writes);
+    CHECK(after.style_reads == before.style_reads);
+    CHECK(after.opacity_writes == before.opacity_writes + 1);
+}
+
+TEST_CASE(opaque_target_does_not_add_layered) {
+    TestWindows windows;
+    NativeWindowHandle handle = windows.create(1);
+    WindowRecord* record = windows.resolve(1);
+    uint8_t half = 128;
+    uint8_t opaque = 255;
+
+    // 影子状态已是255：不访问系统
+    CHECK(windows.manager.set_opacity(&record, &opaque, 1) == 1);
+    CHECK(!(windows.style_of(handle) & WINDOW_STYLE_LAYERED));
+    CHECK(windows.backend->get_counters().style_writes == 0);
+
+    // 恢复到255时保留LAYERED，之后的渐变不用再切换样式
+    CHECK(windows.manager.set_opacity(&record, &half, 1) == 1);
+    CHECK(windows.manager.set_opacity(&record, &opaque, 1) == 1);
+    CHECK(windows.style_of(handle) & WINDOW_STYLE_LAYERED);
+    CHECK(record->style == windows.style_of(handle));
+}
+
+TEST_CASE(clickable_keeps_layered_while_translucent) {
+    TestWindows windows;
+    NativeWindowHandle handle = windows.create(1);
+    WindowRecord* record = windows.resolve(1);
+    uint8_t half = 128;
+    WindowStyleRequest click_through = clickable_request(false);
+    WindowStyleRequest clickable = clickable_request(true);
+
+    CHECK(windows.manager.set_opacity(&record, &half, 1) == 1);
+    CHECK(windows.manager.apply(&record, &click_through, 1) == 1);
+    CHECK(windows.manager.apply(&record, &clickable, 1) == 1);
+    CHECK((windows.style_of(handle) & WINDOW_STYLE_CLICK_THROUGH_MASK) == WINDOW_STYLE_LAYERED);
+    CHECK(record->style == windows.style_of(handle));
+}
+
+TEST_CASE(failed_layered_write_fails_opacity) {
+    TestWindows windows;
+    NativeWindowHandle handle = windows.create(1);
+    WindowRecord* record = windows.resolve(1);
+    uint8_t half = 128;
+
+    windows.backend->set_fail_writes(handle, true);
+    CHECK(windows.manager.set_opacity(&record, &half, 1) == 0);
+    CHECK(!record->style_known && !record->opacity_known);
+    CHECK(record->in_flight == 0);
+
+    windows.backend->set_fail_writes(handle, false);
+    CHECK(windows.manager.set_opacity(&record, &half, 1) == 1);
+    CHECK(record->style_known && record->style == windows.style_of(handle));
+}